@@ -0,0 +1,83 @@
+#include "Benchmark.h"
+#include "../SnakeCore/Arena.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	constexpr int BOARD_SIZE     = 256;
+	constexpr int NUM_TICKS      = 200000;
+	constexpr int FOOD_PER_SNAKE = 4;
+
+	// Carries on straight, turning off at random now and then or when the way is blocked
+	class WanderBrain : public ArenaBrain
+	{
+	public:
+		explicit WanderBrain(uint64_t seed) : m_rng(seed) {}
+
+		Direction Update(const Arena& arena, int snake) override
+		{
+			const CellPos head = arena.GetHeadPosition(snake);
+			Direction dir = arena.GetDirection(snake);
+			if (m_rng.NextBounded(8) == 0)
+			{
+				dir = static_cast<Direction>((dir + 1 + 2 * m_rng.NextBounded(2)) & 3);
+			}
+
+			for (int turn = 0; turn < 4; turn++)
+			{
+				const Direction candidate = static_cast<Direction>((dir + turn) & 3);
+				const CellPos next = Step(head, candidate);
+				if (arena.InBounds(next.x, next.y) && arena.GetSnakeAt(next.x, next.y) < 0)
+				{
+					return candidate;
+				}
+			}
+			return dir;
+		}
+
+	private:
+		Pcg32 m_rng;
+	};
+
+	void RunCase(int numSnakes)
+	{
+		Arena arena(BOARD_SIZE, BOARD_SIZE, numSnakes, numSnakes * FOOD_PER_SNAKE, 0);
+
+		std::vector<WanderBrain> brains;
+		brains.reserve(numSnakes);
+		for (int i = 0; i < numSnakes; i++)
+		{
+			brains.emplace_back(i);
+			arena.SetBrain(i, &brains.back());
+		}
+
+		// Count the moves made, as fewer snakes are left to move as the games go on
+		uint64_t numMoves = 0;
+		int numGames = 1;
+
+		BenchmarkTimer timer;
+		for (int tick = 0; tick < NUM_TICKS; tick++)
+		{
+			numMoves += arena.CountActive();
+			if (arena.Update() == 0)
+			{
+				arena.Reset(numGames++);
+			}
+		}
+		const double seconds = timer.GetSeconds();
+
+		printf("%8d %10d %8d %16.0f %16.0f\n", numSnakes, NUM_TICKS, numGames, NUM_TICKS / seconds, numMoves / seconds);
+	}
+}
+
+void RunArenaBenchmark()
+{
+	printf("%8s %10s %8s %16s %16s\n", "snakes", "ticks", "games", "ticks/s", "moves/s");
+
+	RunCase(1);
+	RunCase(64);
+	RunCase(256);
+}
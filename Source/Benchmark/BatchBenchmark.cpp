@@ -0,0 +1,200 @@
+#include "Benchmark.h"
+#include "RecordedGames.h"
+#include "../Engine/Jobs/JobSystem.h"
+#include "../SnakeCore/FixedWorld.h"
+#include "../SnakeCore/WorldBatch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	constexpr int NUM_WORLDS      = 4096;
+	constexpr int GAMES_PER_WORLD = 4;
+	constexpr int WORLDS_PER_JOB  = 64; // Few enough that the cells of a job's worlds stay in the L1 cache
+
+	// Sums up how a game ended, to check both kinds of world played it out the same way
+	size_t GetResult(size_t length, SnakeStatus status) { return length * 4 + status; }
+
+	// Which game each world of a batch plays on each tick. Each world plays one game after
+	// another, starting the next as soon as one ends, and the longest games are handed out first,
+	// so worlds don't sit idle waiting for the last long game. Worked out up front from the length
+	// of the games, so only the batch is timed.
+	struct BatchSchedule
+	{
+		struct GameStart
+		{
+			int world;
+			int game;
+		};
+
+		std::vector<Direction> dirs;       // NUM_WORLDS directions for each tick, the input of every world
+		std::vector<int>       firstGames; // Game each world starts with
+		std::vector<GameStart> starts;     // Games started after each world's first, in the order they start
+		std::vector<size_t>    tickStarts; // Index in starts of the first game started on each tick, and one more for the end
+		int numTicks;
+	};
+
+	BatchSchedule ScheduleGames(const RecordedGames& inputs)
+	{
+		const int numGames = inputs.GetNumGames();
+		auto gameLength = [&](int game) { return static_cast<int>(inputs.gameStarts[game + 1] - inputs.gameStarts[game]); };
+
+		std::vector<int> order(numGames);
+		for (int game = 0; game < numGames; game++)
+		{
+			order[game] = game;
+		}
+		std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return gameLength(a) > gameLength(b); });
+
+		// World n starts with the nth longest game, and the rest go to the worlds as they finish
+		BatchSchedule schedule;
+		std::vector<int> startTicks(numGames);
+		std::vector<int> gameWorlds(numGames);
+		std::vector<int> worldEnds(NUM_WORLDS); // Tick after the last one of each world's game
+		for (int world = 0; world < NUM_WORLDS; world++)
+		{
+			const int game = order[world];
+			schedule.firstGames.push_back(game);
+			gameWorlds[game] = world;
+			worldEnds[world] = gameLength(game);
+		}
+
+		schedule.tickStarts.push_back(0);
+
+		int next     = NUM_WORLDS;
+		int numTicks = *std::max_element(worldEnds.begin(), worldEnds.end());
+		for (int tick = 1; next < numGames; tick++)
+		{
+			schedule.tickStarts.push_back(schedule.starts.size());
+			for (int world = 0; world < NUM_WORLDS && next < numGames; world++)
+			{
+				if (worldEnds[world] != tick) continue;
+
+				const int game = order[next++];
+				startTicks[game] = tick;
+				gameWorlds[game] = world;
+				worldEnds[world] = tick + gameLength(game);
+				numTicks = std::max(numTicks, worldEnds[world]);
+
+				schedule.starts.push_back(BatchSchedule::GameStart{ world, game });
+			}
+		}
+
+		schedule.tickStarts.resize(numTicks + 1, schedule.starts.size());
+		schedule.numTicks = numTicks;
+
+		// Worlds without a game are finished, so their input is ignored
+		schedule.dirs.resize(static_cast<size_t>(numTicks) * NUM_WORLDS, DIRECTION_NORTH);
+		for (int game = 0; game < numGames; game++)
+		{
+			const size_t first = inputs.gameStarts[game];
+			for (size_t i = first; i < inputs.gameStarts[game + 1]; i++)
+			{
+				schedule.dirs[(startTicks[game] + i - first) * NUM_WORLDS + gameWorlds[game]] = inputs.dirs[i];
+			}
+		}
+
+		return schedule;
+	}
+
+	// Plays the scheduled games on a batch, with its worlds split into ranges that are spread
+	// over the job system. outResults is given the result of each game.
+	void PlayBatch(const BatchSchedule& schedule, WorldBatch& batch, JobSystem& jobs, std::vector<size_t>& outResults)
+	{
+		std::vector<uint64_t> seeds(NUM_WORLDS);
+		std::vector<int> worldGames(NUM_WORLDS); // Game each world is playing
+		for (int world = 0; world < NUM_WORLDS; world++)
+		{
+			seeds[world]      = schedule.firstGames[world];
+			worldGames[world] = schedule.firstGames[world];
+		}
+
+		batch.ResetAll(seeds.data());
+
+		// Worlds don't depend on each other, so each range is played to the end in one job
+		jobs.ParallelFor(0, NUM_WORLDS, WORLDS_PER_JOB, [&](int first, int last) {
+			for (int tick = 0; tick < schedule.numTicks; tick++)
+			{
+				for (size_t i = schedule.tickStarts[tick]; i < schedule.tickStarts[tick + 1]; i++)
+				{
+					const BatchSchedule::GameStart& start = schedule.starts[i];
+					if (start.world < first || start.world >= last) continue;
+
+					outResults[worldGames[start.world]] = GetResult(batch.GetLength(start.world), batch.GetStatus(start.world));
+					batch.Reset(start.world, start.game);
+					worldGames[start.world] = start.game;
+				}
+
+				batch.Update(first, last, &schedule.dirs[static_cast<size_t>(tick) * NUM_WORLDS]);
+			}
+		});
+
+		for (int world = 0; world < NUM_WORLDS; world++)
+		{
+			outResults[worldGames[world]] = GetResult(batch.GetLength(world), batch.GetStatus(world));
+		}
+	}
+
+	template <int W, int H>
+	void RunCase(JobSystem& singleThread, JobSystem& allThreads)
+	{
+		// Work out the games up front, so both kinds of world are timed on the same input
+		const int numGames = NUM_WORLDS * GAMES_PER_WORLD;
+		const RecordedGames inputs = RecordGames<W, H>(numGames);
+		const BatchSchedule schedule = ScheduleGames(inputs);
+
+		std::vector<size_t> fixedResults(numGames);
+		std::vector<size_t> batchResults(numGames);
+		std::vector<size_t> threadedResults(numGames);
+
+		// Both are created up front, so allocating them isn't timed
+		FixedWorld<W, H> fixedWorld(0);
+		std::vector<uint64_t> seeds(NUM_WORLDS);
+		WorldBatch batch(NUM_WORLDS, W, H, seeds.data());
+
+		BenchmarkTimer fixedTimer;
+		for (int game = 0; game < numGames; game++)
+		{
+			fixedWorld.Reset(game);
+			for (size_t i = inputs.gameStarts[game]; i < inputs.gameStarts[game + 1]; i++)
+			{
+				fixedWorld.Update(inputs.dirs[i]);
+			}
+			fixedResults[game] = GetResult(fixedWorld.GetLength(), fixedWorld.GetStatus());
+		}
+		const double fixedRate = inputs.dirs.size() / fixedTimer.GetSeconds();
+
+		BenchmarkTimer batchTimer;
+		PlayBatch(schedule, batch, singleThread, batchResults);
+		const double batchRate = inputs.dirs.size() / batchTimer.GetSeconds();
+
+		BenchmarkTimer threadedTimer;
+		PlayBatch(schedule, batch, allThreads, threadedResults);
+		const double threadedRate = inputs.dirs.size() / threadedTimer.GetSeconds();
+
+		if (batchResults != fixedResults || threadedResults != fixedResults)
+		{
+			printf("Batched worlds don't match!\n");
+		}
+
+		char board[16];
+		snprintf(board, sizeof(board), "%dx%d", W, H);
+		printf("%10s %8d %12zu %16.0f %16.0f %8.2fx %16.0f\n", board, NUM_WORLDS, inputs.dirs.size(), fixedRate, batchRate, batchRate / fixedRate, threadedRate);
+	}
+}
+
+void RunBatchBenchmark()
+{
+	JobSystem singleThread(0);
+	JobSystem allThreads;
+
+	printf("%d threads\n", allThreads.GetNumThreads());
+	printf("%10s %8s %12s %16s %16s %9s %16s\n", "board", "worlds", "ticks", "Fixed ticks/s", "Batch ticks/s", "speedup", "Threaded ticks/s");
+
+	RunCase<10, 10>(singleThread, allThreads);
+	RunCase<20, 20>(singleThread, allThreads);
+	RunCase<32, 32>(singleThread, allThreads);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+
+// Measures the wall-clock time since it was created
+class BenchmarkTimer
+{
+public:
+	BenchmarkTimer() : m_start(std::chrono::steady_clock::now()) {}
+
+	double GetSeconds() const
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+	}
+
+private:
+	std::chrono::steady_clock::time_point m_start;
+};
+
+// Measures how the job system scales from one thread up to every hardware thread
+void RunJobsBenchmark();
+
+// Measures how fast worlds can be saved to and restored from snapshots, for lookahead searches
+void RunCloneBenchmark();
+
+// Compares the speed of World with FixedWorld on the board sizes that are simulated at scale
+void RunFixedWorldBenchmark();
+
+// Measures how fast arenas of many snakes sharing one board can be stepped
+void RunArenaBenchmark();
+
+// Compares stepping many worlds at once with WorldBatch against playing the same games one at
+// a time with FixedWorld
+void RunBatchBenchmark();
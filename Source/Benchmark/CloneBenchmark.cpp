@@ -0,0 +1,113 @@
+#include "Benchmark.h"
+#include "../SnakeCore/World.h"
+#include "../SnakeCore/WorldSnapshot.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace
+{
+	constexpr int NUM_CLONES = 1 << 16;
+
+	struct CloneCase
+	{
+		int width;
+		int height;
+		size_t length;
+	};
+
+	const CloneCase CASES[] =
+	{
+		{  20,  20,    3 },
+		{  20,  20,  200 },
+		{  64,  64,    3 },
+		{  64,  64, 2000 },
+		{ 256, 256,    3 },
+		{ 256, 256, 2000 },
+	};
+
+	// Puts a snake of the given length into the world, winding back and forth along the rows
+	// from the top-left corner, with the food just past its head
+	void LayOutSnake(World& world, size_t length)
+	{
+		const int width = world.GetWidth();
+		std::vector<CellPos> segments(length);
+		for (size_t i = 0; i < length; i++)
+		{
+			// Cells are numbered from the tail, so the head ends up at the highest
+			const int cell = static_cast<int>(length - 1 - i);
+			const int y = cell / width;
+			const int x = (y % 2 == 0) ? cell % width : width - 1 - cell % width;
+			segments[i] = CellPos{ static_cast<CellCoord>(x), static_cast<CellCoord>(y) };
+		}
+
+		const int foodCell = static_cast<int>(length);
+		const int foodY = foodCell / width;
+		const int foodX = (foodY % 2 == 0) ? foodCell % width : width - 1 - foodCell % width;
+
+		WorldState state;
+		world.GetState(state);
+		state.foodPosition = CellPos{ static_cast<CellCoord>(foodX), static_cast<CellCoord>(foodY) };
+		state.direction = DirectionBetween(segments[length > 1 ? 1 : 0], segments[0]);
+		world.SetState(state, segments.data(), length);
+	}
+}
+
+void RunCloneBenchmark()
+{
+	printf("%10s %8s %8s %14s %14s %14s\n", "board", "length", "bytes", "saves/s", "restores/s", "new worlds/s");
+
+	for (const CloneCase& test : CASES)
+	{
+		World world(test.width, test.height, 1);
+		LayOutSnake(world, test.length);
+
+		// Enough storage for every snapshot, allocated up front as a search would
+		const size_t snapshotSize = world.GetSnapshotSize();
+		const size_t stride = (snapshotSize + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+		std::vector<uint64_t> storage(stride * NUM_CLONES);
+
+		BenchmarkTimer saveTimer;
+		for (int i = 0; i < NUM_CLONES; i++)
+		{
+			world.Save(&storage[stride * i]);
+		}
+		const double saveRate = NUM_CLONES / saveTimer.GetSeconds();
+
+		World clone(test.width, test.height, 2);
+		uint64_t checksum = 0;
+
+		BenchmarkTimer restoreTimer;
+		for (int i = 0; i < NUM_CLONES; i++)
+		{
+			clone.Restore(*reinterpret_cast<const WorldSnapshot*>(&storage[stride * i]));
+			checksum += clone.GetSnake()->GetHeadPosition().x;
+		}
+		const double restoreRate = NUM_CLONES / restoreTimer.GetSeconds();
+
+		// What cloning took before snapshots: a whole new world, with every array allocated
+		constexpr int NUM_NEW_WORLDS = NUM_CLONES / 16;
+		BenchmarkTimer newTimer;
+		for (int i = 0; i < NUM_NEW_WORLDS; i++)
+		{
+			World newWorld(test.width, test.height, i);
+			newWorld.Restore(*reinterpret_cast<const WorldSnapshot*>(&storage[stride * i]));
+			checksum += newWorld.GetSnake()->GetHeadPosition().y;
+		}
+		const double newRate = NUM_NEW_WORLDS / newTimer.GetSeconds();
+
+		const size_t expectedChecksum = NUM_CLONES * static_cast<size_t>(world.GetSnake()->GetHeadPosition().x) +
+			NUM_NEW_WORLDS * static_cast<size_t>(world.GetSnake()->GetHeadPosition().y);
+		if (checksum != expectedChecksum || memcmp(&storage[0], &storage[stride * (NUM_CLONES - 1)], snapshotSize) != 0)
+		{
+			printf("Restored worlds don't match!\n");
+		}
+
+		char board[16];
+		snprintf(board, sizeof(board), "%dx%d", test.width, test.height);
+		printf("%10s %8zu %8zu %14.0f %14.0f %14.0f\n", board, test.length, snapshotSize, saveRate, restoreRate, newRate);
+	}
+}
@@ -0,0 +1,72 @@
+#include "Benchmark.h"
+#include "RecordedGames.h"
+#include "../SnakeCore/FixedWorld.h"
+#include "../SnakeCore/ReplayBrain.h"
+#include "../SnakeCore/World.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	constexpr int NUM_GAMES = 2000;
+
+	template <int W, int H>
+	void RunCase()
+	{
+		// Work out the games up front, so both worlds are timed on the same input
+		const RecordedGames inputs = RecordGames<W, H>(NUM_GAMES);
+
+		std::vector<size_t> worldResults(NUM_GAMES);
+		std::vector<size_t> fixedResults(NUM_GAMES);
+
+		World world(W, H, 0);
+		ReplayBrain brain;
+
+		BenchmarkTimer worldTimer;
+		for (int game = 0; game < NUM_GAMES; game++)
+		{
+			world.Reset(game);
+			for (size_t i = inputs.gameStarts[game]; i < inputs.gameStarts[game + 1]; i++)
+			{
+				brain.SetDirection(inputs.dirs[i]);
+				world.Update(brain);
+			}
+			worldResults[game] = world.GetSnake()->GetLength() * 4 + world.GetSnake()->IsDead();
+		}
+		const double worldRate = inputs.dirs.size() / worldTimer.GetSeconds();
+
+		FixedWorld<W, H> fixedWorld(0);
+
+		BenchmarkTimer fixedTimer;
+		for (int game = 0; game < NUM_GAMES; game++)
+		{
+			fixedWorld.Reset(game);
+			for (size_t i = inputs.gameStarts[game]; i < inputs.gameStarts[game + 1]; i++)
+			{
+				fixedWorld.Update(inputs.dirs[i]);
+			}
+			fixedResults[game] = fixedWorld.GetLength() * 4 + (fixedWorld.GetStatus() == STATUS_DEAD);
+		}
+		const double fixedRate = inputs.dirs.size() / fixedTimer.GetSeconds();
+
+		if (worldResults != fixedResults)
+		{
+			printf("Fixed worlds don't match!\n");
+		}
+
+		char board[16];
+		snprintf(board, sizeof(board), "%dx%d", W, H);
+		printf("%10s %12zu %16.0f %16.0f %8.2fx\n", board, inputs.dirs.size(), worldRate, fixedRate, fixedRate / worldRate);
+	}
+}
+
+void RunFixedWorldBenchmark()
+{
+	printf("%10s %12s %16s %16s %9s\n", "board", "ticks", "World ticks/s", "Fixed ticks/s", "speedup");
+
+	RunCase<10, 10>();
+	RunCase<20, 20>();
+	RunCase<32, 32>();
+}
@@ -0,0 +1,116 @@
+#include "Benchmark.h"
+#include "../Engine/Jobs/JobSystem.h"
+#include "../SnakeCore/WorldTypes.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	constexpr int NUM_WALKS      = 1 << 16;
+	constexpr int STEPS_PER_WALK = 4096;
+	constexpr int NUM_TINY_JOBS  = 1 << 18;
+
+	// A compute-bound stand-in for a simulation: walks a head around a 64x64 board,
+	// turning pseudo-randomly and bouncing off the edges. Returns a checksum of the walk.
+	uint32_t RandomWalk(uint32_t seed)
+	{
+		constexpr int BOARD_SIZE = 64;
+
+		uint32_t state = seed * 747796405u + 2891336453u;
+		CellPos pos{ BOARD_SIZE / 2, BOARD_SIZE / 2 };
+		Direction dir = DIRECTION_EAST;
+		uint32_t checksum = 0;
+
+		for (int i = 0; i < STEPS_PER_WALK; i++)
+		{
+			state = state * 1664525u + 1013904223u;
+			if ((state >> 28) == 0)
+			{
+				dir = static_cast<Direction>((dir + 1 + ((state >> 27) & 1) * 2) & 3);
+			}
+
+			const CellPos next = Step(pos, dir);
+			if (next.x < 0 || next.x >= BOARD_SIZE || next.y < 0 || next.y >= BOARD_SIZE)
+			{
+				dir = Opposite(dir);
+				continue;
+			}
+
+			pos = next;
+			checksum += pos.x * BOARD_SIZE + pos.y;
+		}
+
+		return checksum;
+	}
+
+	// Returns the thread counts to measure: powers of two, then every hardware thread
+	std::vector<int> GetThreadCounts()
+	{
+		const int maxThreads = JobSystem::DefaultNumWorkers() + 1;
+
+		std::vector<int> counts;
+		for (int numThreads = 1; numThreads < maxThreads; numThreads *= 2)
+		{
+			counts.push_back(numThreads);
+		}
+		counts.push_back(maxThreads);
+		return counts;
+	}
+}
+
+void RunJobsBenchmark()
+{
+	printf("%d hardware threads\n", static_cast<int>(std::thread::hardware_concurrency()));
+	printf("%8s %12s %10s %10s %14s\n", "threads", "walks/s", "speedup", "efficiency", "tiny jobs/s");
+
+	double baseRate = 0.0;
+	uint32_t expectedChecksum = 0;
+
+	for (int numThreads : GetThreadCounts())
+	{
+		JobSystem jobs(numThreads - 1);
+
+		// Scaling: independent, evenly sized chunks of work
+		std::atomic<uint32_t> checksum(0);
+		BenchmarkTimer walkTimer;
+		jobs.ParallelFor(0, NUM_WALKS, 0, [&checksum](int first, int last) {
+			uint32_t sum = 0;
+			for (int i = first; i < last; i++)
+			{
+				sum += RandomWalk(static_cast<uint32_t>(i));
+			}
+			checksum += sum;
+		});
+		const double walkRate = NUM_WALKS / walkTimer.GetSeconds();
+
+		if (numThreads == 1)
+		{
+			baseRate = walkRate;
+			expectedChecksum = checksum;
+		}
+
+		if (checksum != expectedChecksum)
+		{
+			printf("Checksum mismatch with %d threads!\n", numThreads);
+		}
+
+		// Overhead: many jobs that do almost nothing
+		std::atomic<int> counter(0);
+		BenchmarkTimer tinyTimer;
+		TaskGroup group;
+		for (int i = 0; i < NUM_TINY_JOBS; i++)
+		{
+			jobs.Run(group, [&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+		}
+		jobs.Wait(group);
+		const double tinyRate = NUM_TINY_JOBS / tinyTimer.GetSeconds();
+
+		const double speedup = walkRate / baseRate;
+		printf("%8d %12.0f %9.2fx %9.0f%% %14.0f\n", numThreads, walkRate, speedup, 100.0 * speedup / numThreads, tinyRate);
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../SnakeCore/FixedWorld.h"
+
+#include <cstdlib>
+#include <vector>
+
+// Directions of a set of games, with where each game's directions start, worked out up front so
+// different kinds of world can be timed on the same input
+struct RecordedGames
+{
+	std::vector<Direction> dirs;
+	std::vector<size_t>    gameStarts; // One more than there are games, the last being the end of dirs
+
+	int GetNumGames() const { return static_cast<int>(gameStarts.size()) - 1; }
+};
+
+// Heads for the food, turning off at random when the way is blocked, until the game ends
+template <int W, int H>
+void PlayGame(FixedWorld<W, H>& world, Pcg32& rng, std::vector<Direction>& outDirs)
+{
+	while (world.GetStatus() == STATUS_ACTIVE)
+	{
+		const CellPos head = world.GetHeadPosition();
+		const CellPos food = world.GetFoodPosition();
+		const Direction forward = world.GetDirection();
+
+		Direction best = forward;
+		int bestScore = -1;
+		for (int turn = 0; turn < 3; turn++)
+		{
+			const Direction dir = static_cast<Direction>((forward + 3 + turn) & 3);
+			const CellPos next = Step(head, dir);
+
+			int score = 0;
+			if (world.InBounds(next.x, next.y) && (world.IsFree(next.x, next.y) || world.HasFoodAt(next.x, next.y)))
+			{
+				const int distance = std::abs(food.x - next.x) + std::abs(food.y - next.y);
+				score = 2 * (W + H) - distance + static_cast<int>(rng.NextBounded(2));
+			}
+
+			if (score > bestScore)
+			{
+				best = dir;
+				bestScore = score;
+			}
+		}
+
+		outDirs.push_back(best);
+		world.Update(best);
+	}
+}
+
+// Plays numGames games on a W x H board, the nth started from seed n
+template <int W, int H>
+RecordedGames RecordGames(int numGames)
+{
+	RecordedGames games;
+	Pcg32 rng(W * H);
+
+	FixedWorld<W, H> world(0);
+	for (int game = 0; game < numGames; game++)
+	{
+		world.Reset(game);
+		games.gameStarts.push_back(games.dirs.size());
+		PlayGame(world, rng, games.dirs);
+	}
+	games.gameStarts.push_back(games.dirs.size());
+
+	return games;
+}
@@ -0,0 +1,59 @@
+#include "Benchmark.h"
+#include "../Engine/Math/Random.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+	struct BenchmarkEntry
+	{
+		const char* name;
+		void (*run)();
+	};
+
+	const BenchmarkEntry BENCHMARKS[] =
+	{
+		{ "jobs",  RunJobsBenchmark },
+		{ "clone", RunCloneBenchmark },
+		{ "fixed", RunFixedWorldBenchmark },
+		{ "arena", RunArenaBenchmark },
+		{ "batch", RunBatchBenchmark },
+	};
+}
+
+// Runs every benchmark, or only the ones named on the command line
+int main(int argc, char** argv)
+{
+	Random::Init();
+
+	bool ranAny = false;
+	for (const BenchmarkEntry& benchmark : BENCHMARKS)
+	{
+		bool selected = argc <= 1;
+		for (int i = 1; i < argc; i++)
+		{
+			selected |= strcmp(argv[i], benchmark.name) == 0;
+		}
+
+		if (!selected) continue;
+
+		printf("***** [%s] *****\n", benchmark.name);
+		benchmark.run();
+		ranAny = true;
+	}
+
+	if (!ranAny)
+	{
+		printf("Unknown benchmark. Available benchmarks:");
+		for (const BenchmarkEntry& benchmark : BENCHMARKS)
+		{
+			printf(" %s", benchmark.name);
+		}
+		printf("\n");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
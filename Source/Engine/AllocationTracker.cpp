@@ -0,0 +1,122 @@
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace
+{
+	thread_local AllocationCounts t_counts = {};
+}
+
+namespace AllocationTracker
+{
+	AllocationCounts GetCounts()
+	{
+		return t_counts;
+	}
+}
+
+#if ALLOCATION_TRACKING_ENABLED
+
+namespace
+{
+	void* TrackedAlloc(size_t size)
+	{
+		t_counts.numAllocations++;
+		t_counts.numBytes += size;
+
+		// Every allocation must have its own address, even one of no bytes
+		return std::malloc(size > 0 ? size : 1);
+	}
+}
+
+// The replacements for the global operator new and delete. Every other form (arrays, nothrow,
+// sized deletes and, where the compiler has them, over-aligned types) is replaced too, so every
+// allocation is counted and memory is never freed by a different allocator to the one that
+// allocated it.
+void* operator new(size_t size)
+{
+	void* p = TrackedAlloc(size);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	void* p = TrackedAlloc(size);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept   { return TrackedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedAlloc(size); }
+
+void operator delete(void* p) noexcept                            { std::free(p); }
+void operator delete[](void* p) noexcept                          { std::free(p); }
+void operator delete(void* p, size_t) noexcept                    { std::free(p); }
+void operator delete[](void* p, size_t) noexcept                  { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept     { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept   { std::free(p); }
+
+#if defined(__cpp_aligned_new)
+
+namespace
+{
+	void* TrackedAlignedAlloc(size_t size, std::align_val_t alignment)
+	{
+		t_counts.numAllocations++;
+		t_counts.numBytes += size;
+
+		size_t align = static_cast<size_t>(alignment);
+		size = size > 0 ? size : 1;
+#if defined(_WIN32)
+		return _aligned_malloc(size, align);
+#else
+		// posix_memalign only takes multiples of the size of a pointer
+		align = align > sizeof(void*) ? align : sizeof(void*);
+		void* p = nullptr;
+		return posix_memalign(&p, align, size) == 0 ? p : nullptr;
+#endif
+	}
+
+	void AlignedFree(void* p)
+	{
+#if defined(_WIN32)
+		_aligned_free(p);
+#else
+		std::free(p);
+#endif
+	}
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	void* p = TrackedAlignedAlloc(size, alignment);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	void* p = TrackedAlignedAlloc(size, alignment);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept   { return TrackedAlignedAlloc(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAlignedAlloc(size, alignment); }
+
+void operator delete(void* p, std::align_val_t) noexcept                          { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept                        { AlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept                  { AlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept                { AlignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept   { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(p); }
+
+#endif
+
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts the memory allocated through the global operator new, so code that should run without
+// touching the heap (like a game's ticks once it has warmed up) can be checked.
+//
+// Tracking replaces the global operator new and delete, so it is only built into debug builds,
+// or release builds that define TRACK_ALLOCATIONS. Elsewhere the counts always read as 0.
+// Allocations are counted for each thread separately, so jobs running on other threads don't
+// show up in the counts of the code being checked.
+#if !defined(NDEBUG) || defined(TRACK_ALLOCATIONS)
+#define ALLOCATION_TRACKING_ENABLED 1
+#else
+#define ALLOCATION_TRACKING_ENABLED 0
+#endif
+
+struct AllocationCounts
+{
+	uint64_t numAllocations;
+	uint64_t numBytes;
+};
+
+namespace AllocationTracker
+{
+	// Returns true if allocations are being counted in this build
+	constexpr bool IsEnabled() { return ALLOCATION_TRACKING_ENABLED != 0; }
+
+	// Returns the allocations made on this thread since it started
+	AllocationCounts GetCounts();
+}
+
+// Counts the allocations made on this thread from when it is constructed, e.g. over a frame
+// or a tick
+class AllocationScope
+{
+public:
+	AllocationScope()
+		: m_start(AllocationTracker::GetCounts())
+	{
+	}
+
+	// Returns the allocations made on this thread since the scope started
+	AllocationCounts GetCounts() const
+	{
+		const AllocationCounts now = AllocationTracker::GetCounts();
+		return AllocationCounts{ now.numAllocations - m_start.numAllocations, now.numBytes - m_start.numBytes };
+	}
+
+private:
+	AllocationCounts m_start;
+};
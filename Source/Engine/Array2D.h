@@ -1,79 +1,200 @@
 #pragma once
 
+#include "Span.h"
+
 #include <algorithm>
 #include <cassert>
-#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Stores the elements of an Array2D a row at a time, so rows can be handed out as spans
+class RowMajorLayout
+{
+public:
+	static constexpr bool ROWS_ARE_CONTIGUOUS = true;
+
+	RowMajorLayout(int width = 0, int height = 0)
+		: m_width(width)
+		, m_height(height)
+	{
+	}
+
+	size_t Index(int x, int y) const { return static_cast<size_t>(y) * m_width + x; }
+
+	// Number of elements the storage holds
+	size_t Capacity() const { return static_cast<size_t>(m_width) * m_height; }
+
+private:
+	int m_width;
+	int m_height;
+};
+
+// Stores the elements of an Array2D in Morton (Z-order) order, which interleaves the bits of
+// x and y so that cells near each other in both directions are usually near each other in
+// memory. Suits work that looks at the neighbours of cells, like flood fills, better than
+// work that goes along rows.
+//
+// The storage is padded out to a power of two cells along each side. Where one side is longer,
+// the bits it has beyond the shorter side's are placed above the interleaved ones.
+class MortonLayout
+{
+public:
+	static constexpr bool ROWS_ARE_CONTIGUOUS = false;
+
+	MortonLayout(int width = 0, int height = 0)
+		: m_bitsX(CountBits(width))
+		, m_bitsY(CountBits(height))
+		, m_sharedBits(m_bitsX < m_bitsY ? m_bitsX : m_bitsY)
+	{
+	}
+
+	size_t Index(int x, int y) const
+	{
+		const uint32_t ux = static_cast<uint32_t>(x);
+		const uint32_t uy = static_cast<uint32_t>(y);
+		const uint32_t sharedMask = (uint32_t(1) << m_sharedBits) - 1;
+
+		// Only the longer side has bits beyond the shared ones, so at most one of these is non-zero
+		const uint64_t high = static_cast<uint64_t>((ux >> m_sharedBits) | (uy >> m_sharedBits)) << (2 * m_sharedBits);
+		return static_cast<size_t>(high | Spread(ux & sharedMask) | (Spread(uy & sharedMask) << 1));
+	}
+
+	size_t Capacity() const { return size_t(1) << (m_bitsX + m_bitsY); }
+
+private:
+	// Bits needed to index the given number of cells
+	static int CountBits(int cells)
+	{
+		int bits = 0;
+		while ((int64_t(1) << bits) < cells)
+		{
+			bits++;
+		}
+		return bits;
+	}
+
+	// Moves bit i of v to bit 2i
+	static uint64_t Spread(uint32_t v)
+	{
+		uint64_t r = v;
+		r = (r | (r << 16)) & 0x0000FFFF0000FFFFull;
+		r = (r | (r << 8))  & 0x00FF00FF00FF00FFull;
+		r = (r | (r << 4))  & 0x0F0F0F0F0F0F0F0Full;
+		r = (r | (r << 2))  & 0x3333333333333333ull;
+		r = (r | (r << 1))  & 0x5555555555555555ull;
+		return r;
+	}
 
-template <class T>
+	int m_bitsX;
+	int m_bitsY;
+	int m_sharedBits;
+};
+
+// A 2D array of elements. The Layout decides where each element is kept in the storage (see
+// RowMajorLayout and MortonLayout); whichever is used, the storage starts on a cache line and
+// elements are found by their coordinates.
+//
+// Elements are default-initialised, so arrays of plain types start out uninitialised rather
+// than being cleared and then overwritten. Use the constructor taking a value or Fill to set them.
+template <class T, class Layout = RowMajorLayout>
 class Array2D
 {
 public:
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+	static_assert(alignof(T) <= CACHE_LINE_SIZE, "Elements can't be aligned to more than a cache line");
+
 	Array2D(int width = 0, int height = 0)
-		: m_array(width* height ? new T[width * height] : nullptr)
+		: m_pAllocation(nullptr)
+		, m_array(nullptr)
+		, m_layout(width, height)
 		, m_width(width)
 		, m_height(height)
+		, m_capacity(0)
 	{
+		Allocate();
+		std::for_each(m_array, m_array + m_capacity, [](T& element) { new (&element) T; });
+	}
+
+	Array2D(int width, int height, const T& value)
+		: Array2D(width, height)
+	{
+		Fill(value);
 	}
 
 	Array2D(const Array2D& src)
-		: m_array(src.m_array ? new T[src.m_width * src.m_height] : nullptr)
+		: m_pAllocation(nullptr)
+		, m_array(nullptr)
+		, m_layout(src.m_layout)
 		, m_width(src.m_width)
 		, m_height(src.m_height)
+		, m_capacity(0)
 	{
-		std::copy(src.m_array, src.m_array + src.Size(), m_array);
+		// Both arrays have the same layout, so the storage is copied as it is
+		Allocate();
+		std::uninitialized_copy(src.m_array, src.m_array + src.m_capacity, m_array);
+	}
+
+	Array2D(Array2D&& src) noexcept
+		: Array2D(0, 0)
+	{
+		Swap(*this, src);
 	}
 
 	~Array2D()
 	{
-		if (m_array != 0)
-		{
-			delete[] m_array;
-		}
-		m_array = 0;
+		Free();
 	}
 
-	Array2D& operator=(Array2D rhs)
+	// Takes rhs by value, so assigning from a temporary or std::move moves rather than copies
+	Array2D& operator=(Array2D rhs) noexcept
 	{
 		Swap(*this, rhs);
 		return *this;
 	}
 
-	friend void Swap(Array2D& a, Array2D& b)
+	friend void Swap(Array2D& a, Array2D& b) noexcept
 	{
+		std::swap(a.m_pAllocation, b.m_pAllocation);
+		std::swap(a.m_array, b.m_array);
+		std::swap(a.m_layout, b.m_layout);
 		std::swap(a.m_width, b.m_width);
 		std::swap(a.m_height, b.m_height);
-		std::swap(a.m_array, b.m_array);
+		std::swap(a.m_capacity, b.m_capacity);
 	}
 
+	// Changes the size of the array, keeping the elements that are inside both the old and new sizes.
+	// Row-major arrays that only change height keep their storage while it's big enough.
 	void Resize(int newWidth, int newHeight)
 	{
-		T* newArray = new T[newWidth * newHeight];
+		if (newWidth == m_width && newHeight == m_height) return;
+
+		const Layout newLayout(newWidth, newHeight);
+		if (Layout::ROWS_ARE_CONTIGUOUS && newWidth == m_width && newLayout.Capacity() <= m_capacity)
+		{
+			// The rows that are kept stay where they are; only the ones dropped are cleaned up
+			std::for_each(m_array + newLayout.Capacity(), m_array + m_capacity, [](T& element) { element = T(); });
+			m_layout = newLayout;
+			m_height = newHeight;
+			return;
+		}
+
+		Array2D resized(newWidth, newHeight);
 
 		// Determine the size of the sub-array that can fit within the new array
-		int minX = (newWidth < m_width ? newWidth : m_width);
-		int minY = (newHeight < m_height ? newHeight : m_height);
+		const int minX = (newWidth < m_width ? newWidth : m_width);
+		const int minY = (newHeight < m_height ? newHeight : m_height);
 
-		// Move data over
 		for (int y = 0; y < minY; y++)
 		{
-			int newRowStartIndex = y * newWidth;
-			int oldRowStartIndex = y * m_width;
-
 			for (int x = 0; x < minX; x++)
 			{
-				// Calculate the index of row and col in new array and copy from index in old array
-				newArray[newRowStartIndex + x] = m_array[oldRowStartIndex + x];
+				resized.Get(x, y) = std::move(Get(x, y));
 			}
 		}
 
-		if (m_array != 0)
-		{
-			delete[] m_array;
-		}
-
-		m_array = newArray;
-		m_width = newWidth;
-		m_height = newHeight;
+		Swap(*this, resized);
 	}
 
 	T& Get(int x, int y)
@@ -81,7 +202,7 @@ public:
 		assert(x >= 0 && x < m_width);
 		assert(y >= 0 && y < m_height);
 
-		return m_array[y * m_width + x];
+		return m_array[m_layout.Index(x, y)];
 	}
 
 	const T& Get(int x, int y) const
@@ -89,15 +210,138 @@ public:
 		assert(x >= 0 && x < m_width);
 		assert(y >= 0 && y < m_height);
 
-		return m_array[y * m_width + x];
+		return m_array[m_layout.Index(x, y)];
 	}
 
+	// Sets every element to value. The storage is filled in one go, which compilers vectorise.
+	void Fill(const T& value)
+	{
+		std::fill(m_array, m_array + m_capacity, value);
+	}
+
+	// Sets every element in the rectangle of elements from (x, y) of the given size to value,
+	// a row at a time where rows are contiguous. The rectangle must lie within the array.
+	void FillRect(int x, int y, int width, int height, const T& value)
+	{
+		AssertRectInside(x, y, width, height);
+		if (width == 0 || height == 0) return;
+
+		if (Layout::ROWS_ARE_CONTIGUOUS)
+		{
+			Span2D<T>(m_array + m_layout.Index(x, y), width, height, static_cast<size_t>(m_width)).Fill(value);
+			return;
+		}
+
+		for (int cy = y; cy < y + height; cy++)
+		{
+			for (int cx = x; cx < x + width; cx++)
+			{
+				Get(cx, cy) = value;
+			}
+		}
+	}
+
+	// Copies the rectangle of elements from (srcX, srcY) of the given size in src to (dstX, dstY)
+	// in this array, a row at a time where both have contiguous rows. Both rectangles must lie
+	// within their arrays, and mustn't overlap if src is this array.
+	template <class SrcLayout>
+	void CopyRect(const Array2D<T, SrcLayout>& src, int srcX, int srcY, int width, int height, int dstX, int dstY)
+	{
+		src.AssertRectInside(srcX, srcY, width, height);
+		AssertRectInside(dstX, dstY, width, height);
+		if (width == 0 || height == 0) return;
+
+		if (Layout::ROWS_ARE_CONTIGUOUS && SrcLayout::ROWS_ARE_CONTIGUOUS)
+		{
+			for (int row = 0; row < height; row++)
+			{
+				const T* pSrcRow = &src.Get(srcX, srcY + row);
+				std::copy(pSrcRow, pSrcRow + width, &Get(dstX, dstY + row));
+			}
+			return;
+		}
+
+		for (int row = 0; row < height; row++)
+		{
+			for (int column = 0; column < width; column++)
+			{
+				Get(dstX + column, dstY + row) = src.Get(srcX + column, srcY + row);
+			}
+		}
+	}
+
+	// Views of a row or a rectangle of elements, for arrays with a row-major layout
+	Span<T> Row(int y)
+	{
+		static_assert(Layout::ROWS_ARE_CONTIGUOUS, "Rows can only be viewed when they are contiguous");
+		return Span2D<T>(m_array, m_width, m_height, static_cast<size_t>(m_width)).Row(y);
+	}
+
+	Span<const T> Row(int y) const
+	{
+		static_assert(Layout::ROWS_ARE_CONTIGUOUS, "Rows can only be viewed when they are contiguous");
+		return Span2D<const T>(m_array, m_width, m_height, static_cast<size_t>(m_width)).Row(y);
+	}
+
+	Span2D<T> View(int x, int y, int width, int height)
+	{
+		static_assert(Layout::ROWS_ARE_CONTIGUOUS, "Rectangles can only be viewed when rows are contiguous");
+		AssertRectInside(x, y, width, height);
+		return Span2D<T>(m_array + m_layout.Index(x, y), width, height, static_cast<size_t>(m_width));
+	}
+
+	Span2D<const T> View(int x, int y, int width, int height) const
+	{
+		static_assert(Layout::ROWS_ARE_CONTIGUOUS, "Rectangles can only be viewed when rows are contiguous");
+		AssertRectInside(x, y, width, height);
+		return Span2D<const T>(m_array + m_layout.Index(x, y), width, height, static_cast<size_t>(m_width));
+	}
+
+	// The storage, which holds Capacity() elements in the order given by the layout
+	T*       Data()       { return m_array; }
+	const T* Data() const { return m_array; }
+	size_t   Capacity() const { return m_capacity; }
+
 	int Width()  const { return m_width; }
 	int Height() const { return m_height; }
 	int Size()   const { return m_width * m_height; }
 
 private:
-	T* m_array;
-	int m_width;
-	int m_height;
-};
\ No newline at end of file
+	template <class, class> friend class Array2D;
+
+	void AssertRectInside(int x, int y, int width, int height) const
+	{
+		assert(width >= 0 && height >= 0);
+		assert(x >= 0 && x + width <= m_width);
+		assert(y >= 0 && y + height <= m_height);
+		(void)x; (void)y; (void)width; (void)height;
+	}
+
+	// Allocates uninitialised storage for the layout's elements, starting on a cache line
+	void Allocate()
+	{
+		m_capacity = m_width > 0 && m_height > 0 ? m_layout.Capacity() : 0;
+		if (m_capacity == 0) return;
+
+		m_pAllocation = ::operator new(m_capacity * sizeof(T) + CACHE_LINE_SIZE - 1);
+		const uintptr_t address = reinterpret_cast<uintptr_t>(m_pAllocation);
+		m_array = reinterpret_cast<T*>((address + CACHE_LINE_SIZE - 1) & ~static_cast<uintptr_t>(CACHE_LINE_SIZE - 1));
+	}
+
+	void Free()
+	{
+		std::for_each(m_array, m_array + m_capacity, [](T& element) { element.~T(); });
+		::operator delete(m_pAllocation);
+
+		m_pAllocation = nullptr;
+		m_array       = nullptr;
+		m_capacity    = 0;
+	}
+
+	void*    m_pAllocation; // Start of the memory allocated, which m_array is aligned within
+	T*       m_array;
+	Layout   m_layout;
+	int      m_width;
+	int      m_height;
+	size_t   m_capacity; // Elements constructed in the storage, including any padding
+};
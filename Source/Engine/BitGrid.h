@@ -0,0 +1,477 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Bits
+{
+	// Returns the number of set bits in v
+	inline int PopCount(uint64_t v)
+	{
+#if defined(_MSC_VER)
+		// Split into halves so this also works when targeting 32-bit platforms
+		return static_cast<int>(__popcnt(static_cast<uint32_t>(v)) + __popcnt(static_cast<uint32_t>(v >> 32)));
+#else
+		return __builtin_popcountll(v);
+#endif
+	}
+
+	// Returns the index of the lowest set bit in v, which must not be zero
+	inline int CountTrailingZeros(uint64_t v)
+	{
+		assert(v != 0);
+#if defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, static_cast<uint32_t>(v)))
+		{
+			return static_cast<int>(index);
+		}
+		_BitScanForward(&index, static_cast<uint32_t>(v >> 32));
+		return static_cast<int>(index) + 32;
+#else
+		return __builtin_ctzll(v);
+#endif
+	}
+
+	// Returns the number of zero bits above the highest set bit in v, which must not be zero
+	inline int CountLeadingZeros(uint64_t v)
+	{
+		assert(v != 0);
+#if defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanReverse(&index, static_cast<uint32_t>(v >> 32)))
+		{
+			return 31 - static_cast<int>(index);
+		}
+		_BitScanReverse(&index, static_cast<uint32_t>(v));
+		return 63 - static_cast<int>(index);
+#else
+		return __builtin_clzll(v);
+#endif
+	}
+
+	// Returns the index of the nth (starting from 0) lowest set bit in v
+	inline int SelectNth(uint64_t v, int n)
+	{
+		assert(n >= 0 && n < PopCount(v));
+
+		// Discard the n lowest set bits
+		for (int i = 0; i < n; i++)
+		{
+			v &= v - 1;
+		}
+		return CountTrailingZeros(v);
+	}
+
+	// Returns the index of the nth (starting from 0) clear bit among the first numValidBits bits
+	// of numWords words, or -1 if there are fewer than n + 1 of them. Whole words are skipped
+	// using their popcount, so only the word holding the bit is searched bit by bit.
+	// Word i is read from pWords[i * stride], so the words can be interleaved with other grids'.
+	inline int64_t FindNthClear(const uint64_t* pWords, int numWords, int64_t numValidBits, int64_t n, size_t stride = 1)
+	{
+		assert(n >= 0);
+		assert(numValidBits <= static_cast<int64_t>(numWords) * 64);
+
+		for (int w = 0; w < numWords; w++)
+		{
+			const int64_t numBitsLeft = numValidBits - static_cast<int64_t>(w) * 64;
+			if (numBitsLeft <= 0) break;
+
+			const uint64_t validBits = numBitsLeft >= 64 ? ~uint64_t(0) : (uint64_t(1) << numBitsLeft) - 1;
+			const uint64_t clearBits = ~pWords[w * stride] & validBits;
+			const int numClear       = PopCount(clearBits);
+
+			if (n < numClear)
+			{
+				return static_cast<int64_t>(w) * 64 + SelectNth(clearBits, static_cast<int>(n));
+			}
+			n -= numClear;
+		}
+
+		return -1;
+	}
+}
+
+// A 2D grid of bits packed into 64-bit words.
+// Each row starts on a new word, so a row can be read a word at a time.
+//
+// The words are stored in chunks of 64x64 cells (one word from each of 64 rows), which are
+// only allocated once a bit in them is set, so a grid takes memory in proportion to the
+// area that has been written to rather than its size. Bits in chunks that were never
+// allocated read as clear.
+//
+// Every chunk is stamped with the epoch it was last written in, and chunks stamped with an
+// older epoch read as all clear. Clearing the whole grid just starts a new epoch, so it
+// takes the same time however large the grid is; stale chunks are only zeroed once they
+// are next written to.
+//
+// Grids of up to MAX_FLAT_SIZE cells are stored flat instead: every word is allocated up
+// front in one row-major array, so a word is read without looking up its chunk, and
+// ClearAll zeroes the words, which takes no longer than starting an epoch at that size.
+class BitGrid
+{
+public:
+	typedef uint64_t Word;
+	static constexpr int BITS_PER_WORD = 64;
+	static constexpr int CHUNK_SIZE    = BITS_PER_WORD; // Cells along each side of a chunk
+	static constexpr int64_t MAX_FLAT_SIZE = 256 * 256; // Most cells a grid stored flat can have
+
+	BitGrid(int width = 0, int height = 0)
+		: m_pFlatWords(IsFlat(width, height) ? new Word[static_cast<size_t>(WordsPerRow(width)) * height]() : nullptr)
+		, m_chunks(IsFlat(width, height) ? 0 : static_cast<size_t>(WordsPerRow(width)) * ChunksPerColumn(height))
+		, m_epoch(0)
+		, m_width(width)
+		, m_height(height)
+		, m_wordsPerRow(WordsPerRow(width))
+	{
+	}
+
+	bool Get(int x, int y) const
+	{
+		assert(x >= 0 && x < m_width);
+		assert(y >= 0 && y < m_height);
+
+		return (ReadWord(x / BITS_PER_WORD, y) >> BitIndex(x)) & 1;
+	}
+
+	// Sets or clears a bit. Returns true if the bit changed.
+	bool Set(int x, int y)   { return Change(x, y, true); }
+	bool Clear(int x, int y) { return Change(x, y, false); }
+
+	// Clears every bit in the grid
+	void ClearAll()
+	{
+		if (m_pFlatWords)
+		{
+			std::fill(m_pFlatWords.get(), m_pFlatWords.get() + NumFlatWords(), Word(0));
+			return;
+		}
+
+		m_epoch++;
+
+		// Once the epoch wraps around, chunks from the first epochs would read as valid again
+		if (m_epoch == 0)
+		{
+			for (std::unique_ptr<Chunk>& pChunk : m_chunks)
+			{
+				if (pChunk)
+				{
+					pChunk->Clear(m_epoch);
+				}
+			}
+		}
+	}
+
+	// Returns the number of set bits in the grid. Only the chunks in use are counted.
+	int64_t CountSet() const
+	{
+		int64_t count = 0;
+		if (m_pFlatWords)
+		{
+			for (size_t i = 0; i < NumFlatWords(); i++)
+			{
+				count += Bits::PopCount(m_pFlatWords[i]);
+			}
+			return count;
+		}
+
+		for (const std::unique_ptr<Chunk>& pChunk : m_chunks)
+		{
+			if (!pChunk || pChunk->epoch != m_epoch) continue;
+
+			for (int row = 0; row < CHUNK_SIZE; row++)
+			{
+				count += Bits::PopCount(pChunk->rows[row]);
+			}
+		}
+		return count;
+	}
+
+	// Returns the number of clear bits in the grid
+	int64_t CountClear() const { return Size() - CountSet(); }
+
+	// Finds the nth (starting from 0, in row-major order) clear bit in the grid, counting from
+	// the start of row firstRow. Whole words are skipped using their popcount, so only one word
+	// is searched bit by bit. Returns false if there are fewer than n + 1 clear bits.
+	bool FindNthClear(int64_t n, int& outX, int& outY, int firstRow = 0) const
+	{
+		assert(n >= 0);
+
+		for (int y = firstRow; y < m_height; y++)
+		{
+			for (int w = 0; w < m_wordsPerRow; w++)
+			{
+				const Word clearBits = ~ReadWord(w, y) & ValidBitsMask(w);
+				const int numClear = Bits::PopCount(clearBits);
+
+				if (n < numClear)
+				{
+					outX = w * BITS_PER_WORD + Bits::SelectNth(clearBits, static_cast<int>(n));
+					outY = y;
+					return true;
+				}
+				n -= numClear;
+			}
+		}
+
+		return false;
+	}
+
+	// Returns how many clear bits there are in a line starting at (x, y) and stepping by (dx, dy),
+	// up to the first set bit or the edge of the grid, and at most maxLength.
+	// Horizontal lines are read a word at a time, vertical ones a bit per row.
+	int CountClearRun(int x, int y, int dx, int dy, int maxLength) const
+	{
+		assert((dx == 0) != (dy == 0) && dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1);
+
+		if (x < 0 || x >= m_width || y < 0 || y >= m_height)
+		{
+			return 0;
+		}
+
+		// Clamp to the edge of the grid
+		const int toEdge = dx > 0 ? m_width - x : dx < 0 ? x + 1 : dy > 0 ? m_height - y : y + 1;
+		maxLength = maxLength < toEdge ? maxLength : toEdge;
+
+		if (dy != 0)
+		{
+			int length = 0;
+			while (length < maxLength && !Get(x, y + length * dy))
+			{
+				length++;
+			}
+			return length;
+		}
+
+		int length = 0;
+		while (length < maxLength)
+		{
+			const int cx    = x + length * dx;
+			const int w     = cx / BITS_PER_WORD;
+			const int bit   = cx % BITS_PER_WORD;
+			const Word word = ReadWord(w, y);
+
+			// Bits of the word from the current column onwards, in the direction of travel
+			int numClear;
+			if (dx > 0)
+			{
+				const Word ahead = word >> bit;
+				numClear = ahead != 0 ? Bits::CountTrailingZeros(ahead) : BITS_PER_WORD - bit;
+			}
+			else
+			{
+				const Word ahead = word << (BITS_PER_WORD - 1 - bit);
+				numClear = ahead != 0 ? Bits::CountLeadingZeros(ahead) : bit + 1;
+			}
+
+			length += numClear;
+
+			// Stopped inside the word, so the bit reached is set
+			if (numClear < (dx > 0 ? BITS_PER_WORD - bit : bit + 1))
+				break;
+		}
+		return length < maxLength ? length : maxLength;
+	}
+
+	// Sets length bits in a line starting at (x, y) and stepping by (dx, dy), which must lie
+	// within the grid. Horizontal lines are set a word at a time.
+	// Returns the number of bits that were clear before.
+	int SetRun(int x, int y, int dx, int dy, int length)
+	{
+		assert((dx == 0) != (dy == 0) && dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1);
+
+		int numChanged = 0;
+		if (length <= 0) return numChanged;
+
+		if (dy != 0)
+		{
+			for (int i = 0; i < length; i++)
+			{
+				numChanged += Set(x, y + i * dy);
+			}
+			return numChanged;
+		}
+
+		// Set the same columns from the left end of the line
+		int first = dx > 0 ? x : x - length + 1;
+		const int last = first + length - 1;
+		assert(first >= 0 && last < m_width && y >= 0 && y < m_height);
+
+		while (first <= last)
+		{
+			const int w        = first / BITS_PER_WORD;
+			const int bit      = first % BITS_PER_WORD;
+			const int wordLast = (w + 1) * BITS_PER_WORD - 1 < last ? (w + 1) * BITS_PER_WORD - 1 : last;
+			const int numBits  = wordLast - first + 1;
+
+			const Word bits = numBits == BITS_PER_WORD ? ~Word(0) : ((Word(1) << numBits) - 1) << bit;
+			Word& word = WriteWord(w, y);
+			numChanged += Bits::PopCount(bits & ~word);
+			word |= bits;
+
+			first = wordLast + 1;
+		}
+		return numChanged;
+	}
+
+	// Returns up to 64 bits of row y, starting from column x.
+	// Bit i of the result holds the cell (x + i, y). Bits past the end of the row are zero.
+	Word RowMask(int x, int y) const
+	{
+		assert(x >= 0 && x < m_width);
+		assert(y >= 0 && y < m_height);
+
+		const int w     = x / BITS_PER_WORD;
+		const int shift = x % BITS_PER_WORD;
+
+		Word mask = ReadWord(w, y) >> shift;
+		if (shift != 0 && w + 1 < m_wordsPerRow)
+		{
+			mask |= ReadWord(w + 1, y) << (BITS_PER_WORD - shift);
+		}
+		return mask;
+	}
+
+	// Returns up to 64 bits of column x, starting from row y.
+	// Bit i of the result holds the cell (x, y + i). Bits past the end of the column are zero.
+	Word ColumnMask(int x, int y) const
+	{
+		assert(x >= 0 && x < m_width);
+		assert(y >= 0 && y < m_height);
+
+		const int numRows = std::min(BITS_PER_WORD, m_height - y);
+
+		Word mask = 0;
+		for (int i = 0; i < numRows; i++)
+		{
+			mask |= static_cast<Word>(Get(x, y + i)) << i;
+		}
+		return mask;
+	}
+
+	int Width()    const { return m_width; }
+	int Height()   const { return m_height; }
+	int64_t Size() const { return static_cast<int64_t>(m_width) * m_height; }
+
+	// Returns the number of chunks that have been allocated. A flat grid counts as having all
+	// of its chunks allocated.
+	size_t CountChunks() const
+	{
+		if (m_pFlatWords)
+		{
+			return static_cast<size_t>(m_wordsPerRow) * ChunksPerColumn(m_height);
+		}
+		return static_cast<size_t>(std::count_if(m_chunks.begin(), m_chunks.end(),
+			[](const std::unique_ptr<Chunk>& pChunk) { return pChunk != nullptr; }));
+	}
+
+private:
+	// The words of 64 rows of one 64 column wide strip of the grid
+	struct Chunk
+	{
+		Word     rows[CHUNK_SIZE];
+		uint32_t epoch; // Epoch the chunk was last written in
+
+		void Clear(uint32_t newEpoch)
+		{
+			std::fill(rows, rows + CHUNK_SIZE, Word(0));
+			epoch = newEpoch;
+		}
+	};
+
+	static int WordsPerRow(int width)      { return (width + BITS_PER_WORD - 1) / BITS_PER_WORD; }
+	static int ChunksPerColumn(int height) { return (height + CHUNK_SIZE - 1) / CHUNK_SIZE; }
+
+	static int BitIndex(int x) { return x % BITS_PER_WORD; }
+
+	static bool IsFlat(int width, int height) { return static_cast<int64_t>(width) * height <= MAX_FLAT_SIZE; }
+
+	size_t NumFlatWords() const { return static_cast<size_t>(m_wordsPerRow) * m_height; }
+
+	// Index of the chunk holding the wth word of row y
+	size_t ChunkIndex(int w, int y) const
+	{
+		assert(w >= 0 && w < m_wordsPerRow);
+		assert(y >= 0 && y < m_height);
+
+		return static_cast<size_t>(y / CHUNK_SIZE) * m_wordsPerRow + w;
+	}
+
+	// Index of the wth word of row y in a flat grid
+	size_t FlatIndex(int w, int y) const
+	{
+		assert(w >= 0 && w < m_wordsPerRow);
+		assert(y >= 0 && y < m_height);
+
+		return static_cast<size_t>(y) * m_wordsPerRow + w;
+	}
+
+	bool Change(int x, int y, bool value)
+	{
+		assert(x >= 0 && x < m_width);
+		assert(y >= 0 && y < m_height);
+
+		Word& word = WriteWord(x / BITS_PER_WORD, y);
+		const Word bit = Word(1) << BitIndex(x);
+		const bool changed = ((word & bit) != 0) != value;
+
+		word = value ? (word | bit) : (word & ~bit);
+		return changed;
+	}
+
+	// Returns the wth word of row y, which is all clear if it hasn't been written since the grid
+	// was last cleared
+	Word ReadWord(int w, int y) const
+	{
+		if (m_pFlatWords)
+		{
+			return m_pFlatWords[FlatIndex(w, y)];
+		}
+
+		const Chunk* pChunk = m_chunks[ChunkIndex(w, y)].get();
+		return pChunk && pChunk->epoch == m_epoch ? pChunk->rows[y % CHUNK_SIZE] : Word(0);
+	}
+
+	// Returns the wth word of row y to be modified, allocating its chunk or clearing it first if
+	// it is stale
+	Word& WriteWord(int w, int y)
+	{
+		if (m_pFlatWords)
+		{
+			return m_pFlatWords[FlatIndex(w, y)];
+		}
+
+		std::unique_ptr<Chunk>& pChunk = m_chunks[ChunkIndex(w, y)];
+		if (!pChunk)
+		{
+			pChunk.reset(new Chunk);
+			pChunk->Clear(m_epoch);
+		}
+		else if (pChunk->epoch != m_epoch)
+		{
+			pChunk->Clear(m_epoch);
+		}
+		return pChunk->rows[y % CHUNK_SIZE];
+	}
+
+	// Mask of the bits in the wth word of a row that lie within the grid
+	Word ValidBitsMask(int w) const
+	{
+		const int bitsInWord = std::min(BITS_PER_WORD, m_width - w * BITS_PER_WORD);
+		return bitsInWord == BITS_PER_WORD ? ~Word(0) : (Word(1) << bitsInWord) - 1;
+	}
+
+	std::unique_ptr<Word[]> m_pFlatWords; // Every word of a flat grid, row-major, or null if the grid is chunked
+	std::vector<std::unique_ptr<Chunk>> m_chunks; // Row-major, null until a bit in the chunk is set. Empty if the grid is flat.
+	uint32_t m_epoch;
+	int m_width;
+	int m_height;
+	int m_wordsPerRow;
+};
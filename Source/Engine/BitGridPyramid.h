@@ -0,0 +1,560 @@
+#pragma once
+
+#include "BitGrid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+// A BitGrid with a pyramid of counts over it, for questions about regions of large grids.
+//
+// The grid is split into 64x64 blocks, which line up with its words, and the blocks into
+// 8x8 superblocks of 512x512 cells. Each keeps the number of set bits inside it, updated as
+// bits change. Counting the clear bits in a rectangle then only reads the bits of the blocks
+// on its border, taking whole blocks and superblocks from their counts, and searches skip
+// over any block that is full.
+//
+// The counts are stamped with epochs like the grid's chunks, so clearing the whole grid still
+// takes the same time however large it is.
+class BitGridPyramid
+{
+public:
+	typedef BitGrid::Word Word;
+	static constexpr int BLOCK_SIZE            = BitGrid::BITS_PER_WORD; // Cells along each side of a block
+	static constexpr int BLOCKS_PER_SUPERBLOCK = 8;                      // Blocks along each side of a superblock
+	static constexpr int SUPERBLOCK_SIZE       = BLOCK_SIZE * BLOCKS_PER_SUPERBLOCK;
+
+	BitGridPyramid(int width = 0, int height = 0)
+		: m_grid(width, height)
+		, m_blocksPerRow(CountBlocks(width, BLOCK_SIZE))
+		, m_blocksPerColumn(CountBlocks(height, BLOCK_SIZE))
+		, m_superblocksPerRow(CountBlocks(width, SUPERBLOCK_SIZE))
+		, m_superblocksPerColumn(CountBlocks(height, SUPERBLOCK_SIZE))
+		, m_blockCounts(static_cast<size_t>(m_blocksPerRow) * m_blocksPerColumn, Count{ 0, 0 })
+		, m_superblockCounts(static_cast<size_t>(m_superblocksPerRow) * m_superblocksPerColumn, Count{ 0, 0 })
+		, m_numSet(0)
+		, m_epoch(0)
+	{
+	}
+
+	bool Get(int x, int y) const { return m_grid.Get(x, y); }
+
+	// Sets or clears a bit. Returns true if the bit changed.
+	bool Set(int x, int y)
+	{
+		if (!m_grid.Set(x, y))
+			return false;
+
+		AddToCounts(x, y, 1);
+		return true;
+	}
+
+	bool Clear(int x, int y)
+	{
+		if (!m_grid.Clear(x, y))
+			return false;
+
+		AddToCounts(x, y, -1);
+		return true;
+	}
+
+	// Sets length bits in a line starting at (x, y) and stepping by (dx, dy), which must lie
+	// within the grid. The line is set a block at a time.
+	void SetRun(int x, int y, int dx, int dy, int length)
+	{
+		while (length > 0)
+		{
+			// Cells left in the current block in the direction of travel
+			const int toBlockEdge = dx > 0 ? BLOCK_SIZE - x % BLOCK_SIZE : dx < 0 ? x % BLOCK_SIZE + 1 :
+				dy > 0 ? BLOCK_SIZE - y % BLOCK_SIZE : y % BLOCK_SIZE + 1;
+			const int numCells = length < toBlockEdge ? length : toBlockEdge;
+
+			const int numChanged = m_grid.SetRun(x, y, dx, dy, numCells);
+			if (numChanged > 0)
+			{
+				AddToCounts(x, y, numChanged);
+			}
+
+			x += dx * numCells;
+			y += dy * numCells;
+			length -= numCells;
+		}
+	}
+
+	// Clears every bit in the grid
+	void ClearAll()
+	{
+		m_grid.ClearAll();
+		m_numSet = 0;
+		m_epoch++;
+
+		// Once the epoch wraps around, counts from the first epochs would read as valid again
+		if (m_epoch == 0)
+		{
+			std::fill(m_blockCounts.begin(), m_blockCounts.end(), Count{ 0, m_epoch });
+			std::fill(m_superblockCounts.begin(), m_superblockCounts.end(), Count{ 0, m_epoch });
+		}
+	}
+
+	int64_t CountSet()   const { return m_numSet; }
+	int64_t CountClear() const { return Size() - m_numSet; }
+
+	// Finds the nth (starting from 0, in row-major order) clear bit in the grid, like
+	// BitGrid::FindNthClear. Bands of rows a superblock and then a block high are skipped by
+	// their counts, so only the rows of one band are read from the grid.
+	// Returns false if there are fewer than n + 1 clear bits.
+	bool FindNthClear(int64_t n, int& outX, int& outY) const
+	{
+		assert(n >= 0);
+
+		for (int sy = 0; sy < m_superblocksPerColumn; sy++)
+		{
+			int64_t numSetInBand = 0;
+			for (int sx = 0; sx < m_superblocksPerRow; sx++)
+			{
+				numSetInBand += ReadSuperblockCount(sx, sy);
+			}
+
+			const int bandEnd = SuperblockRect(0, sy).y1;
+			const int64_t numClearInBand = Area(Rect{ 0, sy * SUPERBLOCK_SIZE, Width(), bandEnd }) - numSetInBand;
+			if (n >= numClearInBand)
+			{
+				n -= numClearInBand;
+				continue;
+			}
+
+			for (int by = sy * BLOCKS_PER_SUPERBLOCK; by * BLOCK_SIZE < bandEnd; by++)
+			{
+				int64_t numSetInRow = 0;
+				for (int bx = 0; bx < m_blocksPerRow; bx++)
+				{
+					numSetInRow += ReadBlockCount(bx, by);
+				}
+
+				const int64_t numClearInRow = Area(Rect{ 0, by * BLOCK_SIZE, Width(), BlockRect(0, by).y1 }) - numSetInRow;
+				if (n >= numClearInRow)
+				{
+					n -= numClearInRow;
+					continue;
+				}
+
+				return m_grid.FindNthClear(n, outX, outY, by * BLOCK_SIZE);
+			}
+
+			assert(false && "Block counts are out of date!");
+			return false;
+		}
+
+		return false;
+	}
+
+	// See BitGrid
+	int CountClearRun(int x, int y, int dx, int dy, int maxLength) const { return m_grid.CountClearRun(x, y, dx, dy, maxLength); }
+
+	// Returns the number of clear bits in the rectangle of cells from (x, y) of the given size.
+	// Parts of the rectangle outside the grid are ignored.
+	int64_t CountClearIn(int x, int y, int width, int height) const
+	{
+		Rect rect{ x, y, x + width, y + height };
+		if (!ClipToGrid(rect)) return 0;
+
+		int64_t numSet = 0;
+		ForEachSuperblock(rect, [&](int sx, int sy, const Rect& part, bool whole)
+		{
+			numSet += whole ? ReadSuperblockCount(sx, sy) : CountSetInSuperblock(part);
+			return true;
+		});
+		return Area(rect) - numSet;
+	}
+
+	// Finds the nth (starting from 0) clear bit in the rectangle of cells from (x, y) of the given
+	// size. Bits are counted superblock by superblock and block by block, in row-major order
+	// within each, rather than in row-major order of the whole rectangle.
+	// Returns false if there are fewer than n + 1 clear bits in the rectangle.
+	bool FindNthClearIn(int x, int y, int width, int height, int64_t n, int& outX, int& outY) const
+	{
+		assert(n >= 0);
+
+		Rect rect{ x, y, x + width, y + height };
+		if (!ClipToGrid(rect)) return false;
+
+		bool found = false;
+		ForEachSuperblock(rect, [&](int sx, int sy, const Rect& superPart, bool wholeSuperblock)
+		{
+			const int64_t numSet = wholeSuperblock ? ReadSuperblockCount(sx, sy) : CountSetInSuperblock(superPart);
+			const int64_t numClear = Area(superPart) - numSet;
+			if (n >= numClear)
+			{
+				n -= numClear;
+				return true;
+			}
+
+			ForEachBlock(superPart, [&](int bx, int by, const Rect& part, bool wholeBlock)
+			{
+				const int64_t numClearInBlock = Area(part) - (wholeBlock ? ReadBlockCount(bx, by) : CountSetInCells(part));
+				if (n >= numClearInBlock)
+				{
+					n -= numClearInBlock;
+					return true;
+				}
+
+				// The block is one word wide, so each of its rows is read with one mask
+				for (int cy = part.y0; cy < part.y1; cy++)
+				{
+					const Word clearBits = ~m_grid.RowMask(part.x0, cy) & LowBits(part.x1 - part.x0);
+					const int numClearInRow = Bits::PopCount(clearBits);
+					if (n < numClearInRow)
+					{
+						outX = part.x0 + Bits::SelectNth(clearBits, static_cast<int>(n));
+						outY = cy;
+						found = true;
+						return false;
+					}
+					n -= numClearInRow;
+				}
+
+				assert(false && "Block counts are out of date!");
+				return false;
+			});
+			return false;
+		});
+
+		return found;
+	}
+
+	// Finds several clear bits in one walk over the grid, counting bits in the same order as
+	// FindNthClearIn does over the whole grid. pSortedN holds count distinct ranks in increasing
+	// order, each less than CountClear(), and fn(x, y) is called with each bit found in that order.
+	// Superblocks and blocks without a wanted bit are skipped by their counts.
+	template <class Fn>
+	void FindNthClears(const int64_t* pSortedN, int count, Fn fn) const
+	{
+		if (count == 0) return;
+		assert(pSortedN[0] >= 0 && pSortedN[count - 1] < CountClear());
+
+		int next = 0;          // Index of the next rank to find
+		int64_t numBefore = 0; // Clear bits counted before the current superblock, block or row
+		const Rect gridRect{ 0, 0, Width(), Height() };
+
+		ForEachSuperblock(gridRect, [&](int sx, int sy, const Rect& superPart, bool)
+		{
+			const int64_t numClear = Area(superPart) - ReadSuperblockCount(sx, sy);
+			if (pSortedN[next] >= numBefore + numClear)
+			{
+				numBefore += numClear;
+				return true;
+			}
+
+			ForEachBlock(superPart, [&](int bx, int by, const Rect& part, bool)
+			{
+				const int64_t numClearInBlock = Area(part) - ReadBlockCount(bx, by);
+				if (pSortedN[next] >= numBefore + numClearInBlock)
+				{
+					numBefore += numClearInBlock;
+					return true;
+				}
+
+				for (int cy = part.y0; cy < part.y1 && next < count; cy++)
+				{
+					const Word clearBits = ~m_grid.RowMask(part.x0, cy) & LowBits(part.x1 - part.x0);
+					const int numClearInRow = Bits::PopCount(clearBits);
+
+					// Several of the bits may be in the same row
+					while (next < count && pSortedN[next] < numBefore + numClearInRow)
+					{
+						fn(part.x0 + Bits::SelectNth(clearBits, static_cast<int>(pSortedN[next] - numBefore)), cy);
+						next++;
+					}
+					numBefore += numClearInRow;
+				}
+
+				// Carry on to the next block, unless every bit has been found
+				return next < count;
+			});
+			return next < count;
+		});
+
+		assert(next == count);
+	}
+
+	// Finds the clear bit nearest to (x, y), measuring distance in steps along rows and columns.
+	// Of bits at the same distance, the one in the first block searched is returned.
+	// Returns false if every bit is set.
+	bool FindNearestClear(int x, int y, int& outX, int& outY) const
+	{
+		if (CountClear() == 0) return false;
+
+		int bestDistance = INT32_MAX;
+
+		// Superblocks are searched in rings around the one nearest the cell, until the rings are
+		// further away than the best bit found
+		const int px = Clamp(x, 0, Width() - 1) / SUPERBLOCK_SIZE;
+		const int py = Clamp(y, 0, Height() - 1) / SUPERBLOCK_SIZE;
+		const int maxRing = m_superblocksPerRow > m_superblocksPerColumn ? m_superblocksPerRow : m_superblocksPerColumn;
+
+		for (int ring = 0; ring < maxRing; ring++)
+		{
+			// Every cell of a ring is at least this far away
+			if (ring > 0 && (ring - 1) * SUPERBLOCK_SIZE + 1 >= bestDistance)
+				break;
+
+			for (int sy = py - ring; sy <= py + ring; sy++)
+			{
+				if (sy < 0 || sy >= m_superblocksPerColumn) continue;
+
+				// Rows between the top and bottom of the ring only have a superblock at each end
+				const bool onEdgeRow = sy == py - ring || sy == py + ring;
+				const int step = onEdgeRow || ring == 0 ? 1 : 2 * ring;
+
+				for (int sx = px - ring; sx <= px + ring; sx += step)
+				{
+					if (sx < 0 || sx >= m_superblocksPerRow) continue;
+
+					const Rect superRect = SuperblockRect(sx, sy);
+					if (ReadSuperblockCount(sx, sy) == Area(superRect) || DistanceTo(superRect, x, y) >= bestDistance)
+						continue;
+
+					ForEachBlock(superRect, [&](int bx, int by, const Rect& blockRect, bool)
+					{
+						if (ReadBlockCount(bx, by) < Area(blockRect) && DistanceTo(blockRect, x, y) < bestDistance)
+						{
+							FindNearestClearInBlock(blockRect, x, y, bestDistance, outX, outY);
+						}
+						return true;
+					});
+				}
+			}
+		}
+
+		assert(bestDistance != INT32_MAX);
+		return true;
+	}
+
+	// Bits of row y from column x onwards, see BitGrid
+	Word RowMask(int x, int y) const { return m_grid.RowMask(x, y); }
+
+	const BitGrid& GetGrid() const { return m_grid; }
+
+	int Width()    const { return m_grid.Width(); }
+	int Height()   const { return m_grid.Height(); }
+	int64_t Size() const { return m_grid.Size(); }
+
+private:
+	// Cells from (x0, y0) up to but not including (x1, y1)
+	struct Rect
+	{
+		int x0;
+		int y0;
+		int x1;
+		int y1;
+	};
+
+	static int CountBlocks(int cells, int blockSize) { return (cells + blockSize - 1) / blockSize; }
+	static int Clamp(int v, int min, int max) { return v < min ? min : (v > max ? max : v); }
+	static int64_t Area(const Rect& rect) { return static_cast<int64_t>(rect.x1 - rect.x0) * (rect.y1 - rect.y0); }
+	static int Min(int a, int b) { return a < b ? a : b; }
+	static int Max(int a, int b) { return a > b ? a : b; }
+
+	// Mask of the lowest numBits bits
+	static Word LowBits(int numBits) { return numBits >= BitGrid::BITS_PER_WORD ? ~Word(0) : (Word(1) << numBits) - 1; }
+
+	// Returns the number of steps along rows and columns from (x, y) to the nearest cell of the rect
+	static int DistanceTo(const Rect& rect, int x, int y)
+	{
+		const int dx = x < rect.x0 ? rect.x0 - x : (x >= rect.x1 ? x - rect.x1 + 1 : 0);
+		const int dy = y < rect.y0 ? rect.y0 - y : (y >= rect.y1 ? y - rect.y1 + 1 : 0);
+		return dx + dy;
+	}
+
+	// Clips the rect to the grid. Returns false if nothing is left.
+	bool ClipToGrid(Rect& rect) const
+	{
+		rect.x0 = Max(rect.x0, 0);
+		rect.y0 = Max(rect.y0, 0);
+		rect.x1 = Min(rect.x1, Width());
+		rect.y1 = Min(rect.y1, Height());
+		return rect.x0 < rect.x1 && rect.y0 < rect.y1;
+	}
+
+	Rect SuperblockRect(int sx, int sy) const
+	{
+		return Rect{ sx * SUPERBLOCK_SIZE, sy * SUPERBLOCK_SIZE,
+			Min((sx + 1) * SUPERBLOCK_SIZE, Width()), Min((sy + 1) * SUPERBLOCK_SIZE, Height()) };
+	}
+
+	Rect BlockRect(int bx, int by) const
+	{
+		return Rect{ bx * BLOCK_SIZE, by * BLOCK_SIZE,
+			Min((bx + 1) * BLOCK_SIZE, Width()), Min((by + 1) * BLOCK_SIZE, Height()) };
+	}
+
+	// Calls fn(sx, sy, part, whole) for each superblock overlapping the rect, in row-major order,
+	// where part is the overlap and whole is true if it covers all of the superblock.
+	// Stops early if fn returns false.
+	template <class Fn>
+	void ForEachSuperblock(const Rect& rect, Fn fn) const
+	{
+		for (int sy = rect.y0 / SUPERBLOCK_SIZE; sy <= (rect.y1 - 1) / SUPERBLOCK_SIZE; sy++)
+		{
+			for (int sx = rect.x0 / SUPERBLOCK_SIZE; sx <= (rect.x1 - 1) / SUPERBLOCK_SIZE; sx++)
+			{
+				const Rect superRect = SuperblockRect(sx, sy);
+				const Rect part{ Max(rect.x0, superRect.x0), Max(rect.y0, superRect.y0), Min(rect.x1, superRect.x1), Min(rect.y1, superRect.y1) };
+				const bool whole = part.x0 == superRect.x0 && part.y0 == superRect.y0 && part.x1 == superRect.x1 && part.y1 == superRect.y1;
+
+				if (!fn(sx, sy, part, whole)) return;
+			}
+		}
+	}
+
+	// Calls fn(bx, by, part, whole) for each block overlapping the rect, in the same way as
+	// ForEachSuperblock. Returns false if fn stopped early.
+	template <class Fn>
+	bool ForEachBlock(const Rect& rect, Fn fn) const
+	{
+		for (int by = rect.y0 / BLOCK_SIZE; by <= (rect.y1 - 1) / BLOCK_SIZE; by++)
+		{
+			for (int bx = rect.x0 / BLOCK_SIZE; bx <= (rect.x1 - 1) / BLOCK_SIZE; bx++)
+			{
+				const Rect blockRect = BlockRect(bx, by);
+				const Rect part{ Max(rect.x0, blockRect.x0), Max(rect.y0, blockRect.y0), Min(rect.x1, blockRect.x1), Min(rect.y1, blockRect.y1) };
+				const bool whole = part.x0 == blockRect.x0 && part.y0 == blockRect.y0 && part.x1 == blockRect.x1 && part.y1 == blockRect.y1;
+
+				if (!fn(bx, by, part, whole)) return false;
+			}
+		}
+		return true;
+	}
+
+	// Counts the set bits in part of a superblock, a block at a time
+	int64_t CountSetInSuperblock(const Rect& part) const
+	{
+		int64_t numSet = 0;
+		ForEachBlock(part, [&](int bx, int by, const Rect& blockPart, bool whole)
+		{
+			numSet += whole ? ReadBlockCount(bx, by) : CountSetInCells(blockPart);
+			return true;
+		});
+		return numSet;
+	}
+
+	// Counts the set bits in part of a block, a row at a time
+	int CountSetInCells(const Rect& part) const
+	{
+		const Word mask = LowBits(part.x1 - part.x0);
+
+		int numSet = 0;
+		for (int cy = part.y0; cy < part.y1; cy++)
+		{
+			numSet += Bits::PopCount(m_grid.RowMask(part.x0, cy) & mask);
+		}
+		return numSet;
+	}
+
+	// Updates bestDistance and outX/outY if a clear bit in the block is nearer to (x, y).
+	// Rows are searched outwards from the nearest one, until they are further than the best bit.
+	void FindNearestClearInBlock(const Rect& block, int x, int y, int& bestDistance, int& outX, int& outY) const
+	{
+		const int width = block.x1 - block.x0;
+		const int px = Clamp(x - block.x0, 0, width - 1); // Column of the block nearest to x
+		const int startY = Clamp(y, block.y0, block.y1 - 1);
+		const int startDistance = startY > y ? startY - y : y - startY;
+
+		for (int offset = 0; offset < block.y1 - block.y0; offset++)
+		{
+			if (startDistance + offset >= bestDistance) break;
+
+			// The rows either side of the start, which are the same distance from y
+			for (int side = 0; side < (offset == 0 ? 1 : 2); side++)
+			{
+				const int cy = side == 0 ? startY + offset : startY - offset;
+				if (cy < block.y0 || cy >= block.y1) continue;
+
+				const Word clearBits = ~m_grid.RowMask(block.x0, cy) & LowBits(width);
+				if (clearBits == 0) continue;
+
+				// Nearest clear bits at or right of the column, and left of it
+				int column = -1;
+				int columnDistance = INT32_MAX;
+
+				const Word right = clearBits >> px;
+				if (right != 0)
+				{
+					column = px + Bits::CountTrailingZeros(right);
+					columnDistance = column - px;
+				}
+
+				const Word left = clearBits & LowBits(px);
+				if (left != 0)
+				{
+					const int leftColumn = BitGrid::BITS_PER_WORD - 1 - Bits::CountLeadingZeros(left);
+					if (px - leftColumn < columnDistance)
+					{
+						column = leftColumn;
+						columnDistance = px - leftColumn;
+					}
+				}
+
+				// x may lie outside the block, beyond its nearest column
+				const int cx = block.x0 + column;
+				const int distance = startDistance + offset + (cx > x ? cx - x : x - cx);
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					outX = cx;
+					outY = cy;
+				}
+			}
+		}
+	}
+
+	size_t BlockIndex(int bx, int by) const { return static_cast<size_t>(by) * m_blocksPerRow + bx; }
+	size_t SuperblockIndex(int sx, int sy) const { return static_cast<size_t>(sy) * m_superblocksPerRow + sx; }
+
+	// Returns a count, which is 0 if it hasn't been written since the grid was last cleared
+	int ReadBlockCount(int bx, int by) const { return ReadCount(m_blockCounts[BlockIndex(bx, by)]); }
+	int ReadSuperblockCount(int sx, int sy) const { return ReadCount(m_superblockCounts[SuperblockIndex(sx, sy)]); }
+
+	// Adds to the counts of the block and superblock holding (x, y)
+	void AddToCounts(int x, int y, int delta)
+	{
+		// The coordinates are never negative, so divide them unsigned
+		const unsigned ux = static_cast<unsigned>(x);
+		const unsigned uy = static_cast<unsigned>(y);
+		AddToCount(m_blockCounts[BlockIndex(ux / BLOCK_SIZE, uy / BLOCK_SIZE)], delta);
+		AddToCount(m_superblockCounts[SuperblockIndex(ux / SUPERBLOCK_SIZE, uy / SUPERBLOCK_SIZE)], delta);
+		m_numSet += delta;
+	}
+
+	// Number of set bits in a block or superblock, kept next to its epoch so updating it only
+	// touches one cache line
+	struct Count
+	{
+		int32_t  numSet;
+		uint32_t epoch; // Epoch the count was last written in
+	};
+
+	int ReadCount(const Count& count) const { return count.epoch == m_epoch ? count.numSet : 0; }
+
+	void AddToCount(Count& count, int delta)
+	{
+		if (count.epoch != m_epoch)
+		{
+			count.epoch  = m_epoch;
+			count.numSet = 0;
+		}
+		count.numSet += delta;
+	}
+
+	BitGrid m_grid;
+	int     m_blocksPerRow;
+	int     m_blocksPerColumn;
+	int     m_superblocksPerRow;
+	int     m_superblocksPerColumn;
+
+	std::vector<Count> m_blockCounts;
+	std::vector<Count> m_superblockCounts;
+	int64_t            m_numSet;
+	uint32_t           m_epoch;
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+// A 2D array stored in square chunks, which are only allocated once an element in them is
+// written to. A large array that is only used in places takes memory in proportion to the
+// area that has been written to rather than its size.
+//
+// Elements in chunks that were never allocated read as a default constructed T.
+//
+// Arrays of up to MAX_FLAT_SIZE elements are stored flat instead, in one row-major array
+// allocated up front, so an element is reached without looking up its chunk.
+template <class T>
+class ChunkedArray2D
+{
+public:
+	static constexpr int CHUNK_SIZE = 64; // Elements along each side of a chunk
+	static constexpr int64_t MAX_FLAT_SIZE = 256 * 256; // Most elements an array stored flat can have
+
+	ChunkedArray2D(int width = 0, int height = 0)
+		: m_pFlat(IsFlat(width, height) ? new T[static_cast<size_t>(width) * height]() : nullptr)
+		, m_chunks(IsFlat(width, height) ? 0 : static_cast<size_t>(CountChunks(width)) * CountChunks(height))
+		, m_chunksPerRow(CountChunks(width))
+		, m_width(width)
+		, m_height(height)
+		, m_default()
+	{
+	}
+
+	ChunkedArray2D(ChunkedArray2D&&) = default;
+	ChunkedArray2D& operator=(ChunkedArray2D&&) = default;
+
+	// Returns an element to be modified, allocating its chunk if needed
+	T& Get(int x, int y)
+	{
+		if (m_pFlat)
+		{
+			return m_pFlat[FlatIndex(x, y)];
+		}
+
+		std::unique_ptr<Chunk>& pChunk = m_chunks[ChunkIndex(x, y)];
+		if (!pChunk)
+		{
+			pChunk.reset(new Chunk());
+		}
+		return pChunk->elements[ElementIndex(x, y)];
+	}
+
+	const T& Get(int x, int y) const
+	{
+		if (m_pFlat)
+		{
+			return m_pFlat[FlatIndex(x, y)];
+		}
+
+		const Chunk* pChunk = m_chunks[ChunkIndex(x, y)].get();
+		return pChunk ? pChunk->elements[ElementIndex(x, y)] : m_default;
+	}
+
+	// Frees every chunk, so every element reads as a default constructed T again
+	void Clear()
+	{
+		if (m_pFlat)
+		{
+			std::fill(m_pFlat.get(), m_pFlat.get() + static_cast<size_t>(m_width) * m_height, T());
+			return;
+		}
+
+		std::fill(m_chunks.begin(), m_chunks.end(), nullptr);
+	}
+
+	// Returns the number of chunks that have been allocated. A flat array counts as having all
+	// of its chunks allocated.
+	size_t CountAllocatedChunks() const
+	{
+		if (m_pFlat)
+		{
+			return static_cast<size_t>(CountChunks(m_width)) * CountChunks(m_height);
+		}
+		return static_cast<size_t>(std::count_if(m_chunks.begin(), m_chunks.end(),
+			[](const std::unique_ptr<Chunk>& pChunk) { return pChunk != nullptr; }));
+	}
+
+	int Width()  const { return m_width; }
+	int Height() const { return m_height; }
+
+private:
+	struct Chunk
+	{
+		T elements[CHUNK_SIZE * CHUNK_SIZE];
+	};
+
+	static int CountChunks(int elements) { return (elements + CHUNK_SIZE - 1) / CHUNK_SIZE; }
+
+	static bool IsFlat(int width, int height) { return static_cast<int64_t>(width) * height <= MAX_FLAT_SIZE; }
+
+	size_t FlatIndex(int x, int y) const
+	{
+		assert(x >= 0 && x < m_width);
+		assert(y >= 0 && y < m_height);
+
+		return static_cast<size_t>(y) * m_width + x;
+	}
+
+	size_t ChunkIndex(int x, int y) const
+	{
+		assert(x >= 0 && x < m_width);
+		assert(y >= 0 && y < m_height);
+
+		return static_cast<size_t>(y / CHUNK_SIZE) * m_chunksPerRow + x / CHUNK_SIZE;
+	}
+
+	static int ElementIndex(int x, int y) { return (y % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE; }
+
+	std::unique_ptr<T[]> m_pFlat; // Every element of a flat array, row-major, or null if the array is chunked
+	std::vector<std::unique_ptr<Chunk>> m_chunks; // Row-major, null until an element in the chunk is written. Empty if the array is flat.
+	int m_chunksPerRow;
+	int m_width;
+	int m_height;
+	T   m_default; // Returned for elements of chunks that were never allocated
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Holds a weight for each of a fixed number of items, and keeps running totals of them so
+// that changing a weight, summing a prefix of the weights or finding the item a running total
+// falls in all take O(log n) time (a Fenwick or binary indexed tree).
+//
+// Finding the item a total falls in is what weighted sampling needs: pick a random total below
+// GetTotal() and the item it lands in is chosen with probability proportional to its weight.
+class FenwickTree
+{
+public:
+	typedef uint64_t Sum;
+
+	explicit FenwickTree(size_t size = 0)
+		: m_sums(size + 1, 0)
+		, m_topBit(TopBit(size))
+	{
+	}
+
+	// Sets every weight in O(n) time. pWeights holds Size() weights.
+	void Build(const uint32_t* pWeights)
+	{
+		const size_t size = Size();
+		for (size_t i = 1; i <= size; i++)
+		{
+			m_sums[i] = pWeights[i - 1];
+		}
+
+		// Each node adds itself to its parent, which comes later, so one pass is enough
+		for (size_t i = 1; i <= size; i++)
+		{
+			const size_t parent = i + (i & (0 - i));
+			if (parent <= size)
+			{
+				m_sums[parent] += m_sums[i];
+			}
+		}
+	}
+
+	// Adds delta to the weight of an item. A weight must never go below zero.
+	void Add(size_t index, int64_t delta)
+	{
+		assert(index < Size());
+
+		for (size_t i = index + 1; i < m_sums.size(); i += i & (0 - i))
+		{
+			m_sums[i] += static_cast<Sum>(delta);
+		}
+	}
+
+	// Returns the total weight of the items before index
+	Sum GetPrefixSum(size_t index) const
+	{
+		assert(index <= Size());
+
+		Sum sum = 0;
+		for (size_t i = index; i > 0; i &= i - 1)
+		{
+			sum += m_sums[i];
+		}
+		return sum;
+	}
+
+	// Returns the weight of an item
+	Sum Get(size_t index) const { return GetPrefixSum(index + 1) - GetPrefixSum(index); }
+
+	Sum GetTotal() const { return GetPrefixSum(Size()); }
+
+	// Returns the item whose weights span the given total: the index for which
+	// GetPrefixSum(index) <= total < GetPrefixSum(index + 1). total must be below GetTotal().
+	size_t Find(Sum total) const
+	{
+		assert(total < GetTotal());
+
+		// Walk down from the largest power of two, skipping over nodes whose sums fit below the total
+		size_t index = 0;
+		for (size_t step = m_topBit; step > 0; step >>= 1)
+		{
+			const size_t next = index + step;
+			if (next < m_sums.size() && m_sums[next] <= total)
+			{
+				index = next;
+				total -= m_sums[next];
+			}
+		}
+		return index;
+	}
+
+	size_t Size() const { return m_sums.size() - 1; }
+
+private:
+	// Returns the highest power of two no greater than size, or 0 if size is 0
+	static size_t TopBit(size_t size)
+	{
+		size_t bit = 1;
+		while (bit <= size / 2)
+		{
+			bit <<= 1;
+		}
+		return size > 0 ? bit : 0;
+	}
+
+	std::vector<Sum> m_sums; // m_sums[i] holds the total of the items in (i - (i & -i), i], counting from 1
+	size_t           m_topBit;
+};
@@ -64,12 +64,12 @@ SDL_Texture* Graphics::GetTexture(const std::string& filename)
 	return pTexture;
 }
 
-Sprite* Graphics::CreateSprite(const std::string& texturePath)
+UniqueSpritePtr Graphics::CreateSprite(const std::string& texturePath)
 {
 	SDL_Texture* pTexture = Graphics::GetTexture(texturePath);
 	if (pTexture)
 	{
-		return new Sprite(pTexture);
+		return std::make_unique<Sprite>(pTexture);
 	}
 
 	DebugPrint("Could not create sprite from texture\n");
@@ -79,7 +79,7 @@ Sprite* Graphics::CreateSprite(const std::string& texturePath)
 
 void Graphics::LoadSprite(UniqueSpritePtr& pSprite, const std::string& texturePath)
 {
-	pSprite = UniqueSpritePtr(CreateSprite(texturePath));
+	pSprite = CreateSprite(texturePath);
 	assert(pSprite != nullptr);
 }
 
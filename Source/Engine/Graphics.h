@@ -18,10 +18,10 @@ public:
 
 	void LoadTexture(const std::string& filename);
 	
-	// Creates a sprite from a texture
-	static Sprite* CreateSprite(const std::string& texturePath);
+	// Creates a sprite from a texture. Returns null if the texture isn't loaded.
+	static UniqueSpritePtr CreateSprite(const std::string& texturePath);
 
-	// Creates a sprite, assigning a pointer to it into the given smart pointer
+	// Creates a sprite, moving it into the given smart pointer
 	static void LoadSprite(UniqueSpritePtr& pSprite, const std::string& texturePath);
 
 	// Retrieve a loaded texture by name
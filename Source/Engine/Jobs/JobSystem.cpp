@@ -0,0 +1,124 @@
+#include "JobSystem.h"
+#include "../Util.h"
+
+#include <cassert>
+
+namespace
+{
+	// The pool (if any) that the current thread is a worker of, and the index of its queue
+	thread_local const JobSystem* t_pOwner = nullptr;
+	thread_local int t_queueIndex = 0;
+}
+
+JobSystem::JobSystem(int numWorkers)
+	: m_numQueuedJobs(0)
+	, m_quit(false)
+{
+	assert(numWorkers >= 0);
+
+	for (int i = 0; i < numWorkers + 1; i++)
+	{
+		m_queues.push_back(std::make_unique<WorkQueue<Job>>());
+	}
+
+	m_workers.reserve(numWorkers);
+	for (int i = 0; i < numWorkers; i++)
+	{
+		m_workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+	}
+
+	Util::DebugPrint("Job system started with %d workers\n", numWorkers);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_quit = true;
+	}
+	m_wakeCondition.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+
+	Util::DebugPrint("Job system destroyed\n");
+}
+
+void JobSystem::Run(TaskGroup& group, JobFunction job)
+{
+	group.m_numPending.fetch_add(1, std::memory_order_relaxed);
+	m_queues[GetQueueIndex()]->Push(Job{ std::move(job), &group });
+	m_numQueuedJobs.fetch_add(1, std::memory_order_release);
+
+	// Taking the lock makes sure a worker that is about to sleep sees the new job
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+	m_wakeCondition.notify_one();
+}
+
+void JobSystem::Wait(TaskGroup& group)
+{
+	const int queueIndex = GetQueueIndex();
+
+	// Help out rather than block, so waiting from inside a job can't starve the pool
+	while (!group.IsDone())
+	{
+		if (!RunOneJob(queueIndex))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+int JobSystem::DefaultNumWorkers()
+{
+	// hardware_concurrency() returns 0 if it can't be determined
+	const int numHardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+	return std::max(1, numHardwareThreads) - 1;
+}
+
+void JobSystem::WorkerLoop(int queueIndex)
+{
+	t_pOwner     = this;
+	t_queueIndex = queueIndex;
+
+	while (!m_quit.load(std::memory_order_acquire))
+	{
+		if (RunOneJob(queueIndex))
+			continue;
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_wakeCondition.wait(lock, [this]() {
+			return m_numQueuedJobs.load(std::memory_order_acquire) > 0 || m_quit.load(std::memory_order_acquire);
+		});
+	}
+}
+
+bool JobSystem::RunOneJob(int queueIndex)
+{
+	const int numQueues = static_cast<int>(m_queues.size());
+
+	// Newest job from our own queue first, otherwise steal the oldest job from someone else
+	Job job;
+	bool found = m_queues[queueIndex]->Pop(job);
+	for (int i = 1; i < numQueues && !found; i++)
+	{
+		found = m_queues[(queueIndex + i) % numQueues]->Steal(job);
+	}
+
+	if (!found) return false;
+
+	m_numQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+	job.function();
+	job.pGroup->m_numPending.fetch_sub(1, std::memory_order_release);
+	return true;
+}
+
+int JobSystem::GetQueueIndex() const
+{
+	return t_pOwner == this ? t_queueIndex : 0;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "WorkQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A set of jobs that can be waited on together
+class TaskGroup
+{
+public:
+	TaskGroup() : m_numPending(0) {}
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+
+	// Returns true once every job run in the group has finished
+	bool IsDone() const { return m_numPending.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class JobSystem;
+
+	std::atomic<int> m_numPending;
+};
+
+// Work-stealing thread pool.
+//
+// Every worker thread has its own queue of jobs. A thread runs the jobs in its own queue first,
+// and once that is empty it steals from the other queues, so work spreads out over the pool
+// without a single shared queue for every thread to fight over. Threads outside the pool
+// (such as the main thread) submit to a queue of their own, and help run jobs while they wait.
+class JobSystem
+{
+public:
+	typedef std::function<void()> JobFunction;
+
+	// Creates the pool with numWorkers threads in addition to the thread that waits on the jobs
+	explicit JobSystem(int numWorkers = DefaultNumWorkers());
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Queues a job to be run as part of the group
+	void Run(TaskGroup& group, JobFunction job);
+
+	// Runs queued jobs on the calling thread until every job in the group has finished
+	void Wait(TaskGroup& group);
+
+	// Calls func(first, last) over sub-ranges covering [begin, end), spread over the pool,
+	// and returns once they have all finished. Each sub-range holds at most grainSize indices.
+	// If grainSize is zero, the range is split into a few chunks per thread.
+	template <class Func>
+	void ParallelFor(int begin, int end, int grainSize, const Func& func);
+
+	// Number of threads that run jobs, counting the thread that waits on them
+	int GetNumThreads() const { return static_cast<int>(m_workers.size()) + 1; }
+
+	// One worker per hardware thread, leaving one for the thread that submits the work
+	static int DefaultNumWorkers();
+
+private:
+	struct Job
+	{
+		JobFunction function;
+		TaskGroup*  pGroup;
+	};
+
+	void WorkerLoop(int queueIndex);
+
+	// Runs one job from the thread's own queue, or one stolen from another queue.
+	// Returns false if no job could be found.
+	bool RunOneJob(int queueIndex);
+
+	// Index of the queue owned by the calling thread
+	int GetQueueIndex() const;
+
+	std::vector<std::thread> m_workers;
+
+	// Queue 0 is shared by threads outside the pool, queue i + 1 belongs to worker i
+	std::vector<std::unique_ptr<WorkQueue<Job>>> m_queues;
+
+	// Idle workers sleep until there are queued jobs to run
+	std::mutex              m_sleepMutex;
+	std::condition_variable m_wakeCondition;
+	std::atomic<int>        m_numQueuedJobs;
+	std::atomic<bool>       m_quit;
+};
+
+template <class Func>
+void JobSystem::ParallelFor(int begin, int end, int grainSize, const Func& func)
+{
+	const int count = end - begin;
+	if (count <= 0) return;
+
+	if (grainSize <= 0)
+	{
+		constexpr int CHUNKS_PER_THREAD = 4;
+		grainSize = std::max(1, count / (GetNumThreads() * CHUNKS_PER_THREAD));
+	}
+
+	// Small ranges aren't worth handing out to other threads
+	if (count <= grainSize)
+	{
+		func(begin, end);
+		return;
+	}
+
+	TaskGroup group;
+	for (int first = begin; first < end; first += grainSize)
+	{
+		const int last = std::min(end, first + grainSize);
+		Run(group, [&func, first, last]() { func(first, last); });
+	}
+	Wait(group);
+}
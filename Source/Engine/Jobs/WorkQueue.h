@@ -0,0 +1,46 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <utility>
+
+// Double-ended queue of jobs owned by one thread of a JobSystem.
+// The owner pushes and pops at the back, so it works on its newest (and most cache-friendly)
+// job first. Other threads steal from the front, taking the oldest job, which for recursively
+// split work tends to be the largest one left.
+template <class T>
+class WorkQueue
+{
+public:
+	void Push(T&& item)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_items.push_back(std::move(item));
+	}
+
+	// Takes the newest item. Only called by the queue's owner.
+	bool Pop(T& outItem)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_items.empty()) return false;
+
+		outItem = std::move(m_items.back());
+		m_items.pop_back();
+		return true;
+	}
+
+	// Takes the oldest item. Called by other threads looking for work.
+	bool Steal(T& outItem)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_items.empty()) return false;
+
+		outItem = std::move(m_items.front());
+		m_items.pop_front();
+		return true;
+	}
+
+private:
+	std::mutex    m_mutex;
+	std::deque<T> m_items;
+};
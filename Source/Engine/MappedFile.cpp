@@ -0,0 +1,109 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define NOMINMAX // Keep std::numeric_limits<T>::max usable
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <limits>
+
+MappedFile::MappedFile()
+	: m_pData(nullptr)
+	, m_size(0)
+	, m_open(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const char* path)
+{
+	Close();
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || static_cast<uint64_t>(fileSize.QuadPart) > std::numeric_limits<size_t>::max())
+	{
+		CloseHandle(file);
+		return false;
+	}
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+
+	// Empty files can't be mapped, but there is nothing to read anyway
+	if (m_size > 0)
+	{
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+		{
+			m_pData = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+			// The view keeps the mapping alive
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+#else
+	const int file = open(path, O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0 || static_cast<uint64_t>(fileStat.st_size) > std::numeric_limits<size_t>::max())
+	{
+		close(file);
+		return false;
+	}
+	m_size = static_cast<size_t>(fileStat.st_size);
+
+	// Empty files can't be mapped, but there is nothing to read anyway
+	if (m_size > 0)
+	{
+		void* pMapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (pMapping != MAP_FAILED)
+		{
+			m_pData = static_cast<const uint8_t*>(pMapping);
+		}
+	}
+
+	// The mapping keeps the file alive
+	close(file);
+#endif
+
+	if (m_size > 0 && !m_pData)
+	{
+		m_size = 0;
+		return false;
+	}
+
+	m_open = true;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_pData)
+	{
+#if defined(_WIN32)
+		UnmapViewOfFile(m_pData);
+#else
+		munmap(const_cast<uint8_t*>(m_pData), m_size);
+#endif
+	}
+
+	m_pData = nullptr;
+	m_size  = 0;
+	m_open  = false;
+}
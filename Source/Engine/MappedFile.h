@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// A file mapped read-only into memory.
+// The whole file can be read like an array, but only the pages that are actually touched
+// are loaded by the OS, so opening even a very large file is cheap.
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Maps the file at path, closing any file that was open before.
+	// Returns false if the file couldn't be opened or mapped.
+	bool Open(const char* path);
+	void Close();
+
+	bool IsOpen() const { return m_open; }
+
+	// Contents of the file. Null if it is empty.
+	const uint8_t* GetData() const { return m_pData; }
+	size_t GetSize()         const { return m_size; }
+
+private:
+	const uint8_t* m_pData;
+	size_t         m_size;
+	bool           m_open;
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+// Small, fast and seedable random number generator (PCG-XSH-RR with 64-bit state).
+//
+// Unlike Random, every instance is independent, so each world (or thread) can own one.
+// The whole state is 16 bytes and is only ever advanced with fixed-width integer maths,
+// so the same seed produces the same sequence on every platform and compiler.
+class Pcg32
+{
+public:
+	static constexpr uint64_t DEFAULT_STREAM = 0xda3e39cb94b95bdbULL;
+
+	explicit Pcg32(uint64_t seed = 0, uint64_t stream = DEFAULT_STREAM)
+	{
+		Seed(seed, stream);
+	}
+
+	// Restarts the sequence. Generators with different streams produce unrelated sequences.
+	void Seed(uint64_t seed, uint64_t stream = DEFAULT_STREAM)
+	{
+		m_state     = 0;
+		m_increment = (stream << 1) | 1;
+		Next();
+		m_state += seed;
+		Next();
+	}
+
+	// Produces and returns a random 32-bit number
+	uint32_t Next()
+	{
+		const uint64_t oldState = m_state;
+		m_state = oldState * MULTIPLIER + m_increment;
+
+		const uint32_t xorShifted = static_cast<uint32_t>(((oldState >> 18) ^ oldState) >> 27);
+		const uint32_t rotation   = static_cast<uint32_t>(oldState >> 59);
+		return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31));
+	}
+
+	// Produces and returns a random number in the range [0, range) without bias.
+	// Uses Lemire's multiply-shift method: the result is the top half of a 64-bit product,
+	// and the (slow) modulo is only needed in the rare case that the sample could be biased.
+	uint32_t NextBounded(uint32_t range)
+	{
+		assert(range > 0);
+
+		uint64_t product = static_cast<uint64_t>(Next()) * range;
+		uint32_t low = static_cast<uint32_t>(product);
+
+		if (low < range)
+		{
+			const uint32_t threshold = (0u - range) % range;
+			while (low < threshold)
+			{
+				product = static_cast<uint64_t>(Next()) * range;
+				low = static_cast<uint32_t>(product);
+			}
+		}
+
+		return static_cast<uint32_t>(product >> 32);
+	}
+
+	// Produces and returns a random number in the range [0, range) without bias, for ranges that
+	// may not fit in 32 bits. Ranges that do fit produce the same numbers as NextBounded.
+	uint64_t NextBounded64(uint64_t range)
+	{
+		assert(range > 0);
+
+		if (range <= UINT32_MAX)
+		{
+			return NextBounded(static_cast<uint32_t>(range));
+		}
+
+		// Reject the lowest values, so the values kept are a whole number of multiples of range
+		const uint64_t threshold = (0u - range) % range;
+		for (;;)
+		{
+			// Drawn in two statements, so the order doesn't depend on the compiler
+			const uint64_t high = Next();
+			const uint64_t value = (high << 32) | Next();
+			if (value >= threshold)
+			{
+				return value % range;
+			}
+		}
+	}
+
+	// Produces and returns a random int in the range [min, max]
+	int GetInt(int min, int max)
+	{
+		assert(min <= max);
+		return min + static_cast<int>(NextBounded(static_cast<uint32_t>(max - min) + 1));
+	}
+
+	// Raw state, so a generator can be saved and later restored with SetState
+	uint64_t GetState()     const { return m_state; }
+	uint64_t GetIncrement() const { return m_increment; }
+	void SetState(uint64_t state, uint64_t increment)
+	{
+		m_state     = state;
+		m_increment = increment | 1;
+	}
+
+	bool operator==(const Pcg32& rhs) const { return m_state == rhs.m_state && m_increment == rhs.m_increment; }
+	bool operator!=(const Pcg32& rhs) const { return !(*this == rhs); }
+
+private:
+	static constexpr uint64_t MULTIPLIER = 6364136223846793005ULL;
+
+	uint64_t m_state;
+	uint64_t m_increment; // Selects the stream, always odd
+};
@@ -20,4 +20,11 @@ int Random::GetInt(int min, int max)
 {
 	std::uniform_int_distribution<> dist(min, max);
 	return dist(s_rng);
-}
\ No newline at end of file
+}
+
+uint64_t Random::GetSeed()
+{
+	const uint64_t high = s_rng();
+	const uint64_t low  = s_rng();
+	return (high << 32) | low;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <random>
 
 class Random
@@ -11,6 +12,9 @@ public:
 	// Produces and returns a random int in the range [min, max]
 	static int GetInt(int min, int max);
 
+	// Produces and returns a random seed for a deterministic generator, such as Pcg32
+	static uint64_t GetSeed();
+
 private:
 	static void Seed();
 
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity circular buffer. Elements are addressed by their logical
+// index from the front, so callers never see where the storage wraps around.
+// Pushing or popping at either end is O(1) and never moves other elements.
+template <class T>
+class RingBuffer
+{
+public:
+	class ConstIterator
+	{
+	public:
+		ConstIterator(const RingBuffer* pBuffer, size_t index)
+			: m_pBuffer(pBuffer)
+			, m_index(index)
+		{
+		}
+
+		const T& operator*()  const { return (*m_pBuffer)[m_index]; }
+		const T* operator->() const { return &(*m_pBuffer)[m_index]; }
+
+		ConstIterator& operator++()
+		{
+			m_index++;
+			return *this;
+		}
+
+		bool operator==(const ConstIterator& rhs) const { return m_index == rhs.m_index; }
+		bool operator!=(const ConstIterator& rhs) const { return m_index != rhs.m_index; }
+
+	private:
+		const RingBuffer* m_pBuffer;
+		size_t m_index;
+	};
+
+	RingBuffer(size_t capacity = 0)
+		: m_buffer(capacity)
+		, m_front(0)
+		, m_size(0)
+	{
+	}
+
+	void PushFront(const T& value)
+	{
+		assert(m_size < Capacity() && "Ring buffer is full!");
+
+		m_front = (m_front == 0 ? Capacity() : m_front) - 1;
+		m_buffer[m_front] = value;
+		m_size++;
+	}
+
+	void PushBack(const T& value)
+	{
+		assert(m_size < Capacity() && "Ring buffer is full!");
+
+		m_buffer[ToPhysical(m_size)] = value;
+		m_size++;
+	}
+
+	void PopFront()
+	{
+		assert(m_size > 0);
+
+		m_front = ToPhysical(1);
+		m_size--;
+	}
+
+	void PopBack()
+	{
+		assert(m_size > 0);
+
+		m_size--;
+	}
+
+	// Makes room for at least capacity elements, keeping the ones already held. The elements are
+	// moved to the start of the new storage, so this takes time in proportion to the size.
+	void Reserve(size_t capacity)
+	{
+		if (capacity <= Capacity()) return;
+
+		std::vector<T> buffer(capacity);
+		for (size_t i = 0; i < m_size; i++)
+		{
+			buffer[i] = m_buffer[ToPhysical(i)];
+		}
+
+		m_buffer.swap(buffer);
+		m_front = 0;
+	}
+
+	void Clear()
+	{
+		m_front = 0;
+		m_size  = 0;
+	}
+
+	T& operator[](size_t index)
+	{
+		assert(index < m_size);
+		return m_buffer[ToPhysical(index)];
+	}
+
+	const T& operator[](size_t index) const
+	{
+		assert(index < m_size);
+		return m_buffer[ToPhysical(index)];
+	}
+
+	T& Front()             { return (*this)[0]; }
+	const T& Front() const { return (*this)[0]; }
+	T& Back()              { return (*this)[m_size - 1]; }
+	const T& Back()  const { return (*this)[m_size - 1]; }
+
+	ConstIterator begin() const { return ConstIterator(this, 0); }
+	ConstIterator end()   const { return ConstIterator(this, m_size); }
+
+	size_t Size()     const { return m_size; }
+	size_t Capacity() const { return m_buffer.size(); }
+	bool   Empty()    const { return m_size == 0; }
+
+private:
+	// Maps a logical index onto the underlying storage
+	size_t ToPhysical(size_t index) const
+	{
+		size_t physical = m_front + index;
+		return physical < Capacity() ? physical : physical - Capacity();
+	}
+
+	std::vector<T> m_buffer;
+	size_t m_front; // Physical index of the first element
+	size_t m_size;
+};
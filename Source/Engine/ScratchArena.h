@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Hands out scratch memory that is only needed until the end of a tick or frame, by bumping a
+// pointer through one block. Everything handed out is given back at once by Reset, so nothing
+// is freed piece by piece and nothing is destroyed.
+//
+// A tick that needs more than the block holds gets extra blocks from the heap. They are freed
+// at the next Reset, which grows the main block to cover them, so once the arena has seen its
+// busiest tick, no tick allocates.
+class ScratchArena
+{
+public:
+	explicit ScratchArena(size_t capacity = 0)
+		: m_capacity(0)
+		, m_used(0)
+		, m_overflowBytes(0)
+	{
+		Reserve(capacity);
+	}
+
+	ScratchArena(ScratchArena&&) = default;
+	ScratchArena& operator=(ScratchArena&&) = default;
+
+	// Returns uninitialised room for count elements, which stays valid until the next Reset.
+	// Elements are never destroyed, so only plain types can be stored.
+	template <class T>
+	T* Allocate(size_t count)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "Arena elements are never destroyed");
+		static_assert(alignof(T) <= alignof(Block), "Arena elements can't be aligned more than a block");
+
+		const size_t bytes = count * sizeof(T);
+		const size_t start = (m_used + alignof(T) - 1) & ~(alignof(T) - 1);
+		if (start + bytes <= m_capacity)
+		{
+			m_used = start + bytes;
+			return reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(m_pBlock.get()) + start);
+		}
+
+		m_overflow.push_back(AllocateBlocks(bytes));
+		m_overflowBytes += bytes;
+		return reinterpret_cast<T*>(m_overflow.back().get());
+	}
+
+	// Gives back everything handed out since the last Reset
+	void Reset()
+	{
+		if (m_overflowBytes > 0)
+		{
+			// Room for the whole of the busiest tick, with some slack for alignment
+			const size_t needed = m_used + m_overflowBytes + m_overflow.size() * alignof(Block);
+			m_overflow.clear();
+			m_overflowBytes = 0;
+			Reserve(needed);
+		}
+		m_used = 0;
+	}
+
+	// Makes the main block hold at least capacity bytes. Everything handed out is given back.
+	void Reserve(size_t capacity)
+	{
+		m_used = 0;
+		if (capacity <= m_capacity) return;
+
+		const size_t numBlocks = (capacity + sizeof(Block) - 1) / sizeof(Block);
+		m_pBlock   = AllocateBlocks(capacity);
+		m_capacity = numBlocks * sizeof(Block);
+	}
+
+	// Number of bytes that can be handed out between resets without going to the heap
+	size_t Capacity() const { return m_capacity; }
+
+private:
+	// Storage comes in pieces aligned for any plain type
+	typedef std::max_align_t Block;
+	typedef std::unique_ptr<Block[]> BlockPtr;
+
+	static BlockPtr AllocateBlocks(size_t bytes)
+	{
+		return BlockPtr(new Block[(bytes + sizeof(Block) - 1) / sizeof(Block)]);
+	}
+
+	BlockPtr              m_pBlock;
+	std::vector<BlockPtr> m_overflow;      // Blocks allocated since the last Reset, when the main block ran out
+	size_t                m_capacity;      // Bytes in the main block
+	size_t                m_used;          // Bytes of the main block handed out since the last Reset
+	size_t                m_overflowBytes; // Bytes handed out from overflow blocks since the last Reset
+};
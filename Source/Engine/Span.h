@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+// A run of elements stored one after another, viewed without being owned
+template <class T>
+class Span
+{
+public:
+	Span()
+		: m_pData(nullptr)
+		, m_size(0)
+	{
+	}
+
+	Span(T* pData, size_t size)
+		: m_pData(pData)
+		, m_size(size)
+	{
+	}
+
+	T& operator[](size_t index) const
+	{
+		assert(index < m_size);
+		return m_pData[index];
+	}
+
+	T* begin() const { return m_pData; }
+	T* end()   const { return m_pData + m_size; }
+
+	T*     Data()  const { return m_pData; }
+	size_t Size()  const { return m_size; }
+	bool   Empty() const { return m_size == 0; }
+
+private:
+	T*     m_pData;
+	size_t m_size;
+};
+
+// A rectangle of elements stored a row at a time, viewed without being owned. Each row is
+// contiguous, and starts stride elements after the one before it.
+template <class T>
+class Span2D
+{
+public:
+	Span2D()
+		: m_pData(nullptr)
+		, m_width(0)
+		, m_height(0)
+		, m_stride(0)
+	{
+	}
+
+	Span2D(T* pData, int width, int height, size_t stride)
+		: m_pData(pData)
+		, m_width(width)
+		, m_height(height)
+		, m_stride(stride)
+	{
+		assert(width >= 0 && height >= 0 && static_cast<size_t>(width) <= stride);
+	}
+
+	T& Get(int x, int y) const
+	{
+		assert(x >= 0 && x < m_width);
+		assert(y >= 0 && y < m_height);
+
+		return m_pData[y * m_stride + x];
+	}
+
+	Span<T> Row(int y) const
+	{
+		assert(y >= 0 && y < m_height);
+
+		return Span<T>(m_pData + y * m_stride, static_cast<size_t>(m_width));
+	}
+
+	// Sets every element to value, a row at a time
+	void Fill(const T& value) const
+	{
+		for (int y = 0; y < m_height; y++)
+		{
+			std::fill_n(m_pData + y * m_stride, m_width, value);
+		}
+	}
+
+	int    Width()  const { return m_width; }
+	int    Height() const { return m_height; }
+	size_t Stride() const { return m_stride; }
+
+private:
+	T*     m_pData;
+	int    m_width;
+	int    m_height;
+	size_t m_stride;
+};
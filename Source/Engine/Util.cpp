@@ -1,4 +1,6 @@
+#if defined(_WIN32)
 #include <Windows.h>
+#endif
 #include <cstdarg>
 #include <cstdio>
 
@@ -6,21 +8,27 @@ namespace Util
 {
 	void DebugPrint(const char* format, ...)
 	{
+#if defined(_WIN32)
+		// Formatted on the stack, so printing never allocates and threads can print at once.
+		// Longer messages are cut short rather than dropped.
 		constexpr int BUFFER_SIZE = 1024;
-		static char buffer[BUFFER_SIZE];
+		char buffer[BUFFER_SIZE];
 
 		va_list args;
 		va_start(args, format);
-
-		int len = _vscprintf(format, args) + 1; // Include null-terminating char
-
-		// Prevent buffer overflows
-		if (len > BUFFER_SIZE) return;
-
-		vsprintf_s(buffer, format, args);
+		_vsnprintf_s(buffer, BUFFER_SIZE, _TRUNCATE, format, args);
 		va_end(args);
 
 		// Send to the debugger output window
 		OutputDebugStringA(buffer);
+#elif !defined(NDEBUG)
+		// There is no debugger output window, so use stderr in debug builds
+		va_list args;
+		va_start(args, format);
+		vfprintf(stderr, format, args);
+		va_end(args);
+#else
+		(void)format;
+#endif
 	}
-}
\ No newline at end of file
+}
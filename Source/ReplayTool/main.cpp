@@ -0,0 +1,281 @@
+#include "../Engine/AllocationTracker.h"
+#include "../Engine/MappedFile.h"
+#include "../SnakeCore/ReplayRunner.h"
+#include "../SnakeCore/ReplaySeeker.h"
+#include "../SnakeCore/ReplayWriter.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+namespace
+{
+	const char* STATUS_NAMES[] = { "active", "done", "dead" };
+
+	// Ticks of the game each replay is warmed up on when checking allocations
+	constexpr uint64_t WARM_UP_TICKS = 1000;
+
+	// Boards the games recorded by --check-allocations are played on, and how long for. The
+	// larger board is played for long enough that the snake grows well past the room a body
+	// used to start with on any board (4096 segments).
+	struct CheckedBoard
+	{
+		int      width;
+		int      height;
+		uint64_t maxTicks;
+	};
+	const CheckedBoard CHECKED_BOARDS[] = { { 20, 20, 1000000 }, { 128, 128, 8000000 } };
+
+	void PrintUsage(const char* program)
+	{
+		printf("Usage: %s [--check-allocations] <replay files...>\n", program);
+		printf("       %s --check-allocations\n", program);
+		printf("       %s --seek <tick> <replay file>\n", program);
+	}
+
+	// Direction to move in from (x, y) to follow a cycle through every cell of a board with an
+	// even height: east and west along the rows in turn, leaving column 0 to run back up to the
+	// top row
+	Direction GetCycleDirection(int x, int y, int width, int height)
+	{
+		if (x == 0) return y > 0 ? DIRECTION_NORTH : DIRECTION_EAST;
+		if (y % 2 == 0) return x < width - 1 ? DIRECTION_EAST : DIRECTION_SOUTH;
+		return x > 1 || y == height - 1 ? DIRECTION_WEST : DIRECTION_SOUTH;
+	}
+
+	// Records a game in memory, played by following the cycle above for up to maxTicks ticks.
+	// Once on the cycle, the snake can only die on boards with an odd height.
+	std::string RecordCycleGame(int width, int height, uint64_t seed, uint64_t maxTicks)
+	{
+		std::ostringstream stream;
+		World world(width, height, seed);
+		ReplayWriter writer(stream, width, height, seed);
+		world.SetReplayWriter(&writer);
+
+		SnakeStatus status = STATUS_ACTIVE;
+		uint64_t numTicks = 0;
+		while (status == STATUS_ACTIVE && numTicks < maxTicks)
+		{
+			const CellPos head = world.GetSnake()->GetHeadPosition();
+			Direction dir = GetCycleDirection(head.x, head.y, width, height);
+
+			// The snake can't turn straight back on itself, which the cycle can ask for at the start
+			if (dir == Opposite(world.GetSnake()->GetDirection()))
+			{
+				dir = DIRECTION_SOUTH;
+			}
+
+			// Straight on until the cycle turns
+			uint64_t runLength = 1;
+			for (CellPos pos = Step(head, dir);
+				world.InBounds(pos.x, pos.y) && GetCycleDirection(pos.x, pos.y, width, height) == dir;
+				pos = Step(pos, dir))
+			{
+				runLength++;
+			}
+
+			uint64_t numUpdates;
+			status = world.UpdateStraight(dir, runLength < maxTicks - numTicks ? runLength : maxTicks - numTicks, numUpdates);
+			numTicks += numUpdates;
+		}
+
+		writer.Finish(status, world.GetSnake()->GetLength());
+		world.SetReplayWriter(nullptr);
+		return stream.str();
+	}
+
+	bool RunRecorded(ReplayRunner& runner, const std::string& replay)
+	{
+		return runner.Run(reinterpret_cast<const uint8_t*>(replay.data()), replay.size());
+	}
+
+	// Prints and returns true if the runner's last replay allocated during its ticks
+	bool ReportTickAllocations(const char* name, const ReplayRunner& runner)
+	{
+		const AllocationCounts allocations = runner.GetTickAllocations();
+		if (allocations.numAllocations == 0)
+			return false;
+
+		printf("%s: ALLOCATED %llu times (%llu bytes) during its ticks\n", name,
+			static_cast<unsigned long long>(allocations.numAllocations), static_cast<unsigned long long>(allocations.numBytes));
+		return true;
+	}
+
+	// Records games in memory and checks they play back without allocating during their ticks,
+	// once the world has been warmed up on a different game of the same board size
+	int CheckRecordedGames()
+	{
+		ReplayRunner runner;
+		int numFailed = 0;
+
+		for (const CheckedBoard& board : CHECKED_BOARDS)
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "%dx%d", board.width, board.height);
+
+			const std::string warmUp  = RecordCycleGame(board.width, board.height, 1, WARM_UP_TICKS);
+			const std::string checked = RecordCycleGame(board.width, board.height, 2, board.maxTicks);
+
+			if (!RunRecorded(runner, warmUp) || !RunRecorded(runner, checked) || !runner.Matches())
+			{
+				printf("%s: recorded game didn't play back the way it was recorded\n", name);
+				numFailed++;
+				continue;
+			}
+
+			if (ReportTickAllocations(name, runner))
+			{
+				numFailed++;
+				continue;
+			}
+
+			printf("%s: %llu ticks to length %zu without allocating\n", name,
+				static_cast<unsigned long long>(runner.GetNumTicks()), runner.GetLength());
+		}
+
+		return numFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// Jumps to a tick of a replay and prints the state of the game at that point
+	int Seek(const char* path, uint64_t tick)
+	{
+		MappedFile file;
+		if (!file.Open(path))
+		{
+			printf("%s: couldn't be read\n", path);
+			return EXIT_FAILURE;
+		}
+
+		ReplaySeeker seeker;
+		const auto start = std::chrono::steady_clock::now();
+		const bool valid = seeker.Open(file.GetData(), file.GetSize()) && seeker.Seek(tick);
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (!valid)
+		{
+			printf("%s: not a valid replay\n", path);
+			return EXIT_FAILURE;
+		}
+
+		const World& world = seeker.GetWorld();
+		const Snake* pSnake = world.GetSnake();
+		const CellPos head = pSnake->GetHeadPosition();
+		const CellPos food = world.GetFoodPosition();
+
+		printf("%s: tick %llu, %s, length %zu, head (%d, %d), food (%d, %d)\n", path,
+			static_cast<unsigned long long>(seeker.GetTick()), STATUS_NAMES[seeker.GetStatus()],
+			pSnake->GetLength(), head.x, head.y, food.x, food.y);
+		printf("Seeked in %.3f ms using %zu keyframes every %llu ticks\n", seconds * 1000.0,
+			seeker.GetReplay().GetNumKeyframes(), static_cast<unsigned long long>(seeker.GetReplay().GetKeyframeInterval()));
+
+		return EXIT_SUCCESS;
+	}
+}
+
+// Re-simulates every replay file given on the command line and checks each game
+// ends the way it was recorded. Returns failure if any replay doesn't match.
+// With --check-allocations, each replay also fails if its ticks allocate memory, once the world
+// has warmed up on a different game of the same board size, recorded in memory. Given no
+// files, games recorded in memory are checked instead. This needs a build that tracks
+// allocations (see AllocationTracker.h).
+// With --seek, prints the state of a single replay at the given tick instead.
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		PrintUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (strcmp(argv[1], "--seek") == 0)
+	{
+		if (argc != 4)
+		{
+			PrintUsage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		return Seek(argv[3], strtoull(argv[2], nullptr, 10));
+	}
+
+	const bool checkAllocations = strcmp(argv[1], "--check-allocations") == 0;
+	const int firstFile = checkAllocations ? 2 : 1;
+
+	if (checkAllocations && !AllocationTracker::IsEnabled())
+	{
+		printf("Allocations aren't tracked in this build, use a debug build or define TRACK_ALLOCATIONS\n");
+		return EXIT_FAILURE;
+	}
+
+	if (checkAllocations && argc == 2)
+	{
+		return CheckRecordedGames();
+	}
+
+	ReplayRunner runner;
+	MappedFile file;
+
+	int numMatched = 0;
+	int numFailed  = 0;
+	uint64_t totalTicks = 0;
+	double totalSeconds = 0.0;
+
+	for (int i = firstFile; i < argc; i++)
+	{
+		const char* path = argv[i];
+
+		if (!file.Open(path))
+		{
+			printf("%s: couldn't be read\n", path);
+			numFailed++;
+			continue;
+		}
+
+		// Warming up on the same game would hide anything only this game needs, like the
+		// body growing longer than in any game before
+		ReplayReader header;
+		if (checkAllocations && header.Open(file.GetData(), file.GetSize()))
+		{
+			RunRecorded(runner, RecordCycleGame(header.GetWidth(), header.GetHeight(), header.GetSeed() + 1, WARM_UP_TICKS));
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		const bool valid = runner.Run(file.GetData(), file.GetSize());
+		totalSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (!valid)
+		{
+			printf("%s: not a valid replay\n", path);
+			numFailed++;
+			continue;
+		}
+
+		totalTicks += runner.GetNumTicks();
+
+		if (checkAllocations && ReportTickAllocations(path, runner))
+		{
+			numFailed++;
+			continue;
+		}
+
+		const ReplayReader& replay = runner.GetReplay();
+		if (runner.Matches())
+		{
+			numMatched++;
+			continue;
+		}
+
+		printf("%s: MISMATCH, recorded %s with length %zu after %llu ticks, replayed %s with length %zu after %llu ticks\n", path,
+			STATUS_NAMES[replay.GetRecordedStatus()], replay.GetRecordedLength(), static_cast<unsigned long long>(replay.GetRecordedNumTicks()),
+			STATUS_NAMES[runner.GetStatus()], runner.GetLength(), static_cast<unsigned long long>(runner.GetNumTicks()));
+		numFailed++;
+	}
+
+	printf("%d of %d replays matched, %llu ticks in %.3f seconds (%.0f ticks/s)\n", numMatched, argc - firstFile,
+		static_cast<unsigned long long>(totalTicks), totalSeconds, totalSeconds > 0.0 ? totalTicks / totalSeconds : 0.0);
+
+	return numFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,27 @@
+#include "PlayerBrain.h"
+#include "SnakeGame.h"
+#include "../SnakeCore/Snake.h"
+
+#include <SDL/SDL.h>
+
+void NormalBrain::Update(Snake* pSnake)
+{
+	pSnake->Simulate(m_inputData.lastInputDir);
+}
+
+#if _DEBUG
+void DebugBrain::Update(Snake* pSnake)
+{
+	// Eat requested?
+	if (m_inputData.pKeyboardState[SDL_SCANCODE_SPACE])
+	{
+		pSnake->EatFood(1);
+	}
+
+	// Only move if player hit a movement key this frame
+	if (m_inputData.dirInputThisFrame)
+	{
+		pSnake->Simulate(m_inputData.lastInputDir);
+	}
+}
+#endif
\ No newline at end of file
@@ -1,30 +1,25 @@
 #pragma once
 
-#include "Snake.h"
 #include "SnakeGame.h"
+#include "../SnakeCore/SnakeBrain.h"
 
-#include <SDL/SDL.h>
-
-// Determines snake behaviour
-class SnakeBrain
+// Brain controlled by the player's input
+class PlayerBrain : public SnakeBrain
 {
 public:
-	SnakeBrain() :
+	PlayerBrain() :
 		m_inputData{} 
 	{
 	}
 
-	virtual ~SnakeBrain();
-
 	void SetInput(const InputData& input) { m_inputData = input; }
-	virtual void Update(Snake* pSnake) = 0;
 
 protected:
 	InputData m_inputData;
 };
 
 // Brain used under normal game conditions
-class NormalBrain : public SnakeBrain
+class NormalBrain : public PlayerBrain
 {
 public:
 	virtual void Update(Snake* pSnake) override;
@@ -32,10 +27,10 @@ public:
 
 #if _DEBUG
 // Brain used when debugging
-class DebugBrain : public SnakeBrain
+class DebugBrain : public PlayerBrain
 {
 public:
 	virtual void Update(Snake* pSnake) override;
 
 };
-#endif
\ No newline at end of file
+#endif
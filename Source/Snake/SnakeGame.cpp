@@ -1,6 +1,10 @@
 #include "SnakeGame.h"
-#include "SnakeBrain.h"
-#include "World.h"
+#include "PlayerBrain.h"
+#include "WorldRenderer.h"
+#include "../SnakeCore/World.h"
+#include "../SnakeCore/ReplayWriter.h"
+#include "../SnakeCore/RewindBuffer.h"
+#include "../Engine/AllocationTracker.h"
 #include "../Engine/Math/Vector2.h"
 #include "../Engine/Math/Math.h"
 #include "../Engine/Math/Random.h"
@@ -13,6 +17,8 @@
 #include <memory>
 #include <vector>
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 
 namespace Assets
@@ -24,6 +30,12 @@ namespace Assets
 	const char* SNAKE_FOOD_TEXTURE_PATH = "../../Assets/snake_food.png";
 }
 
+namespace
+{
+	// Every game is recorded to a replay file in here
+	const char* REPLAYS_PATH = "../../Replays/";
+}
+
 namespace
 {
 	typedef const int Command;
@@ -32,20 +44,20 @@ namespace
 	Command MOVE_SOUTH = SDL_SCANCODE_DOWN;
 	Command MOVE_WEST  = SDL_SCANCODE_LEFT;
 
+	Command STEP_BACK    = SDL_SCANCODE_COMMA;
+	Command STEP_FORWARD = SDL_SCANCODE_PERIOD;
+
 	constexpr int   SNAKE_SPEED = 5;				  // How many cells it covers per second
 	constexpr float SNAKE_DELAY = 1.0f / SNAKE_SPEED; // Delay between snake updates in seconds
 
+	constexpr size_t REWIND_TICKS = 10000; // How many of the last ticks can be stepped back through
+
 	constexpr int NORMAL_CELL_SIZE = 32;
 	constexpr int DEBUG_CELL_SIZE  = 128; // This value can be experimental
 }
 
 const int SnakeGame::CELL_SIZE = NORMAL_CELL_SIZE;
 
-const Vector2 SnakeGame::NORTH = Vector2( 0, -1); // In SDL +y faces down
-const Vector2 SnakeGame::EAST  = Vector2( 1,  0);
-const Vector2 SnakeGame::SOUTH = Vector2( 0,  1);
-const Vector2 SnakeGame::WEST  = Vector2(-1,  0);
-
 using std::unique_ptr;
 using std::make_unique;
 using Util::DebugPrint;
@@ -61,10 +73,12 @@ static const char* GetGameOverMessage(SnakeStatus status)
 
 SnakeGame::SnakeGame()
 	: m_pBrain(nullptr)
-	, m_pLastInputDir(nullptr)
+	, m_lastInputDir(DIRECTION_EAST)
+	, m_reportedLength(Snake::INITIAL_LENGTH)
 	, m_nextUpdateTime(0.0f)
 	, m_gameOver(false)
 	, m_startedPlaying(false)
+	, m_rewindStepped(false)
 {
 	static_assert(CELL_SIZE > 0, "Cell size is too small");
 }
@@ -94,7 +108,15 @@ bool SnakeGame::Init()
 	int worldWidth  = static_cast<int>(std::roundf(1.0f * winSize.w / CELL_SIZE)) - 1;
 	int worldHeight = static_cast<int>(std::roundf(1.0f * winSize.h / CELL_SIZE)) - 1;
 
-	m_pWorld = make_unique<World>(worldWidth, worldHeight);
+	const uint64_t seed = Random::GetSeed();
+	DebugPrint("Starting game with seed %llu\n", static_cast<unsigned long long>(seed));
+
+	m_pWorld = make_unique<World>(worldWidth, worldHeight, seed);
+	m_pWorldRenderer = make_unique<WorldRenderer>();
+	m_pRewind = make_unique<RewindBuffer>(REWIND_TICKS);
+	m_lastInputDir = m_pWorld->GetSnake()->GetDirection();
+
+	StartRecording();
 
 	// Create snake brain
 	m_pBrain = make_unique<NormalBrain>();
@@ -112,39 +134,46 @@ void SnakeGame::Shutdown()
 	DBG_PRINT_SEPARATOR("SHUTDOWN");
 	DebugPrint("Beginning game shutdown sequence...\n");
 
+	// The game was quit part way through
+	StopRecording(STATUS_ACTIVE);
+
 	ShutdownSDL();
 }
 
-const Vector2* SnakeGame::GetInputDirection(const Uint8* pKeyState)
+bool SnakeGame::GetInputDirection(const Uint8* pKeyState, Direction& outDir)
 {
-	const Vector2* pInput = NULL;
+	bool hasInput = false;
 
 	if (pKeyState[MOVE_NORTH])
 	{
-		pInput = &NORTH;
+		outDir = DIRECTION_NORTH;
+		hasInput = true;
 	}
 	if (pKeyState[MOVE_EAST])
 	{
-		pInput = &EAST;
+		outDir = DIRECTION_EAST;
+		hasInput = true;
 	}
 	if (pKeyState[MOVE_SOUTH])
 	{
-		pInput = &SOUTH;
+		outDir = DIRECTION_SOUTH;
+		hasInput = true;
 	}
 	if (pKeyState[MOVE_WEST])
 	{
-		pInput = &WEST;
+		outDir = DIRECTION_WEST;
+		hasInput = true;
 	}
 
-	return pInput;
+	return hasInput;
 }
 
-bool SnakeGame::ValidInputDirection(const Vector2& input) const
+bool SnakeGame::ValidInputDirection(Direction input) const
 {
-	const Vector2& snakeDir = m_pWorld->GetSnake()->GetDirection();
+	const Direction snakeDir = m_pWorld->GetSnake()->GetDirection();
 
 	// Cannot be opposite to our current direction
-	return Vector2::Dot(snakeDir, input) != -1.0f;
+	return input != Opposite(snakeDir);
 }
 
 void SnakeGame::ProcessInput()
@@ -160,6 +189,14 @@ void SnakeGame::ProcessInput()
 			case SDL_QUIT:
 				Terminate();
 				break;
+
+			// Key repeats are included, so holding the key keeps stepping
+			case SDL_KEYDOWN:
+				if (m_startedPlaying)
+				{
+					HandleRewindKey(event.key.keysym.scancode);
+				}
+				break;
 		}
 	}
 
@@ -186,22 +223,26 @@ void SnakeGame::ProcessInput()
 		Restart();
 	}
 
+	// The snake can't be turned while paused on an earlier tick, as it might be facing
+	// a different way by the latest one
+	if (!m_pRewind->IsAtLatest()) return;
+
 	// See if player wants to turn snake
-	const Vector2* pInput = GetInputDirection(pState);
+	Direction inputDir;
 
 	bool validInput = false;
-	if (pInput)
+	if (GetInputDirection(pState, inputDir))
 	{
-		validInput = ValidInputDirection(*pInput);
+		validInput = ValidInputDirection(inputDir);
 		if (validInput)
 		{
-			m_pLastInputDir = pInput;
+			m_lastInputDir = inputDir;
 		}
 	}
 
 	// Fill out input data
 	InputData input;
-	input.pLastInputDir     = m_pLastInputDir;
+	input.lastInputDir      = m_lastInputDir;
 	input.dirInputThisFrame = validInput;
 	input.pKeyboardState    = pState;
 
@@ -214,6 +255,10 @@ void SnakeGame::Update()
 	if(!m_startedPlaying || m_gameOver) return;
 
 	AdvanceTimestep();
+
+	// The game is paused while stepping through earlier ticks
+	if (!m_pRewind->IsAtLatest()) return;
+
 	float deltaTime = GetDeltaTime();
 
 	m_nextUpdateTime -= deltaTime;
@@ -223,15 +268,33 @@ void SnakeGame::Update()
 	{
 		m_nextUpdateTime += SNAKE_DELAY;
 
-		SnakeStatus status = m_pWorld->Update(*m_pBrain.get());
+		const AllocationScope tickAllocations;
+		SnakeStatus status = m_pRewind->Update(*m_pWorld, *m_pBrain.get());
+		const Snake* pSnake = m_pWorld->GetSnake();
+
+		// Ticks are meant to run without touching the heap, so any that do are pointed out
+		// (in builds that track allocations)
+		const AllocationCounts allocations = tickAllocations.GetCounts();
+		if (allocations.numAllocations > 0)
+		{
+			DebugPrint("Tick allocated %llu times (%llu bytes)\n",
+				static_cast<unsigned long long>(allocations.numAllocations), static_cast<unsigned long long>(allocations.numBytes));
+		}
+
+		// Report the snake's length once it has finished growing
+		if (status == STATUS_ACTIVE && !pSnake->IsGrowing() && pSnake->GetLength() != m_reportedLength)
+		{
+			m_reportedLength = pSnake->GetLength();
+			printf("Length: %zu\n", m_reportedLength);
+		}
 
 		if (status == STATUS_DEAD || status == STATUS_DONE)
 		{
 			DebugPrint("Game ended.\n");
 
-			const Snake* pSnake = m_pWorld->GetSnake();
 			printf("%s (Length: %zu)\n", GetGameOverMessage(status), pSnake->GetLength());
 
+			StopRecording(status);
 			DoGameOver();
 		}
 	}
@@ -239,8 +302,10 @@ void SnakeGame::Update()
 
 void SnakeGame::Render()
 {
-	// Don't render the game if game over was triggered
-	if(m_gameOver) return;
+	// Don't render the game if game over was triggered, unless the
+	// player is stepping back through how it ended
+	if(m_gameOver && !m_rewindStepped) return;
+	m_rewindStepped = false;
 
 	// Only render the first frame when the player launches the game,
 	// but hasn't begun playing yet
@@ -258,7 +323,7 @@ void SnakeGame::Render()
 	renderer.SetDrawColour(0, 0, 0, 255);
 	renderer.Clear();
 
-	m_pWorld->Render(renderer);
+	m_pWorldRenderer->Render(renderer, *m_pWorld);
 
 	renderer.SwapBuffers();
 }
@@ -273,13 +338,83 @@ void SnakeGame::Restart()
 {
 	DebugPrint("Restarting game...\n");
 
-	m_pWorld->Reset();
+	const uint64_t seed = Random::GetSeed();
+	DebugPrint("Starting game with seed %llu\n", static_cast<unsigned long long>(seed));
+
+	m_pWorld->Reset(seed);
+	m_pRewind->Clear();
+	StartRecording();
 
 	m_nextUpdateTime = 0.0f;
-	m_pLastInputDir = nullptr;
+	m_lastInputDir = m_pWorld->GetSnake()->GetDirection();
+	m_reportedLength = Snake::INITIAL_LENGTH;
 	m_gameOver = false;
 }
 
+void SnakeGame::StartRecording()
+{
+	StopRecording(STATUS_ACTIVE);
+
+	char path[256];
+	snprintf(path, sizeof(path), "%sreplay_%016llx.snkr", REPLAYS_PATH,
+		static_cast<unsigned long long>(m_pWorld->GetSeed()));
+
+	m_pReplayFile = make_unique<std::ofstream>(path, std::ios::binary);
+	if (!*m_pReplayFile)
+	{
+		DebugPrint("Couldn't create replay file '%s', this game won't be recorded\n", path);
+		m_pReplayFile.reset();
+		return;
+	}
+
+	m_pReplayWriter = make_unique<ReplayWriter>(*m_pReplayFile, m_pWorld->GetWidth(), m_pWorld->GetHeight(), m_pWorld->GetSeed());
+	m_pWorld->SetReplayWriter(m_pReplayWriter.get());
+}
+
+void SnakeGame::StopRecording(SnakeStatus status)
+{
+	if (!m_pReplayWriter) return;
+
+	// The replay ends at the latest tick, even if the player has stepped back from it. Redone
+	// ticks aren't recorded again.
+	m_pRewind->StepForward(*m_pWorld, m_pRewind->GetNumTicksBack());
+
+	m_pReplayWriter->Finish(status, m_pWorld->GetSnake()->GetLength());
+	m_pWorld->SetReplayWriter(nullptr);
+
+	DebugPrint("Recorded %llu ticks\n", static_cast<unsigned long long>(m_pReplayWriter->GetNumTicks()));
+
+	m_pReplayWriter.reset();
+	m_pReplayFile.reset();
+}
+
+void SnakeGame::HandleRewindKey(int scancode)
+{
+	size_t numStepped = 0;
+
+	if (scancode == STEP_BACK)
+	{
+		numStepped = m_pRewind->StepBack(*m_pWorld);
+	}
+	else if (scancode == STEP_FORWARD)
+	{
+		numStepped = m_pRewind->StepForward(*m_pWorld);
+	}
+
+	if (numStepped == 0) return;
+
+	m_rewindStepped = true;
+
+	if (m_pRewind->IsAtLatest())
+	{
+		printf("Back at the latest tick\n");
+	}
+	else
+	{
+		printf("Paused %zu ticks back, press '.' to step forward\n", m_pRewind->GetNumTicksBack());
+	}
+}
+
 Vector2 SnakeGame::CalculateRenderOrigin(int renderAreaW, int renderAreaH,
 	int worldWidth, int worldHeight) const
 {
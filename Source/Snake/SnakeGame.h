@@ -3,6 +3,9 @@
 #include "../Engine/SDLApp.h"
 #include "../Engine/Array2D.h"
 #include "../Engine/Math/Vector2.h"
+#include "../SnakeCore/WorldTypes.h"
+
+#include <iosfwd>
 
 namespace Assets
 {
@@ -15,20 +18,16 @@ namespace Assets
 
 struct InputData
 {
-	const Vector2* pLastInputDir; 
+	Direction lastInputDir;
 	const Uint8* pKeyboardState; // Access to the keyboard state
 	bool dirInputThisFrame; // Stores whether the player hit a valid directional key this frame
 };
 
-enum SnakeStatus
-{
-	STATUS_ACTIVE, // There is food to be eaten (Still playing)
-	STATUS_DONE, // All food eaten, (Player won!)
-	STATUS_DEAD, 
-};
-
 class World;
-class SnakeBrain;
+class WorldRenderer;
+class PlayerBrain;
+class ReplayWriter;
+class RewindBuffer;
 
 class SnakeGame : public SDLApp
 {
@@ -40,33 +39,42 @@ public:
 	virtual void ProcessInput() override;
 	virtual void Update()       override;
 	virtual void Render()       override;
-	
-	// Direction vectors representing the four cardinal directions
-	// that the snake can move in
-	static const Vector2 NORTH;
-	static const Vector2 EAST;
-	static const Vector2 SOUTH;
-	static const Vector2 WEST;
 
 private:
 	// Begin game over sequence
 	void DoGameOver();
 	void Restart();
 
+	// Records the game that was just started to a file in the replays directory
+	void StartRecording();
+
+	// Finishes recording the current game, if it is being recorded
+	void StopRecording(SnakeStatus status);
+
+	// Steps the world backwards or forwards through the last ticks played if the key is bound to it
+	void HandleRewindKey(int scancode);
+
 	// Calculate the top-left pos that the renderer will draw the world from
 	Vector2 CalculateRenderOrigin(int renderAreaW, int renderAreaH,
 		int worldWidth, int worldHeight) const;
 
-	static const Vector2* GetInputDirection(const Uint8* pKeyState);
-	bool ValidInputDirection(const Vector2& input) const;
+	// Returns true if a direction key is held, storing its direction in outDir
+	static bool GetInputDirection(const Uint8* pKeyState, Direction& outDir);
+	bool ValidInputDirection(Direction input) const;
 
 	// Size of an individual cell in pixels
 	static const int CELL_SIZE;
 
-	std::unique_ptr<SnakeBrain> m_pBrain;
+	std::unique_ptr<PlayerBrain> m_pBrain;
 	std::unique_ptr<World> m_pWorld;
-	const Vector2* m_pLastInputDir; // Last direction that the player requested
+	std::unique_ptr<WorldRenderer> m_pWorldRenderer;
+	std::unique_ptr<std::ofstream> m_pReplayFile;
+	std::unique_ptr<ReplayWriter> m_pReplayWriter;
+	std::unique_ptr<RewindBuffer> m_pRewind;
+	Direction m_lastInputDir; // Last direction that the player requested
+	size_t m_reportedLength; // Snake length last shown to the player
 	float m_nextUpdateTime; // Time until the next update
 	bool m_gameOver;
 	bool m_startedPlaying;
+	bool m_rewindStepped; // The world was stepped through since the last render
 };
\ No newline at end of file
@@ -1,48 +1,22 @@
 #include "SnakeGraphics.h"
 #include "SnakeGame.h"
-#include "Snake.h"
-#include "World.h"
 #include "WorldUtil.h"
+#include "../Engine/SDLAppRenderer.h"
+#include "../SnakeCore/Snake.h"
+
+#include <cassert>
 
 // Calculates the angle to rotate the graphic for a turn segment
-static float CalculateTurnSpriteRotation(const Vector2& fromParent, const Vector2& fromChild)
+static float CalculateTurnSpriteRotation(Direction fromParent, Direction fromChild)
 {
-	// The turn sprite can be thought of as a single quadrant of a square (or circle depending on it's smoothness).
-	// By rotating this one graphic through each quadrant of the unit-circle, all four potential orientations can be drawn.
-	// This code assumes that the turn texture with no rotation appears to lie in Quadrant I (top-right corner).
-	if ((fromParent == SnakeGame::NORTH) && (fromChild == SnakeGame::EAST)
-		|| (fromParent == SnakeGame::EAST) && (fromChild == SnakeGame::NORTH))
-	{
-		return 0.f;
-	}
-
-	if ((fromParent == SnakeGame::WEST) && (fromChild == SnakeGame::NORTH)
-		|| (fromParent == SnakeGame::NORTH) && (fromChild == SnakeGame::WEST))
-	{
-		return 90.f;
-	}
+	// The segment shouldn't be drawn as a turn otherwise
+	assert(!SameAxis(fromParent, fromChild));
 
-	if ((fromParent == SnakeGame::SOUTH) && (fromChild == SnakeGame::WEST)
-		|| (fromParent == SnakeGame::WEST) && (fromChild == SnakeGame::SOUTH))
-	{
-		return 180.f;
-	}
-
-	if ((fromParent == SnakeGame::EAST) && (fromChild == SnakeGame::SOUTH)
-		|| (fromParent == SnakeGame::SOUTH) && (fromChild == SnakeGame::EAST))
-	{
-		return 270.f;
-	}
-
-	// The segment shouldn't be drawn as a turn.
-	assert(0);
-	return 0.0f;
+	return DirectionTables::TURN_ANGLE[fromParent][fromChild];
 }
 
-SnakeGraphics::SnakeGraphics(int maxSegments)
+SnakeGraphics::SnakeGraphics()
 {
-	m_segmentGraphics.resize(maxSegments);
-
 	// Load all snake sprites
 	Graphics::LoadSprite(m_pTurn, Assets::SNAKE_TURN_TEXTURE_PATH);
 	Graphics::LoadSprite(m_pHead, Assets::SNAKE_HEAD_TEXTURE_PATH);
@@ -50,73 +24,50 @@ SnakeGraphics::SnakeGraphics(int maxSegments)
 	Graphics::LoadSprite(m_pTail, Assets::SNAKE_TAIL_TEXTURE_PATH);
 }
 
-void SnakeGraphics::Init(const Snake& snake)
+void SnakeGraphics::Render(const SDLAppRenderer& renderer, const Snake& snake) const
 {
-	// Should only be called after snake has been initialised
-	assert(snake.GetLength() == Snake::INITIAL_LENGTH);
-
-	const float snakeAngleWorld = WorldUtil::WorldVecToAngle(snake.GetDirection());
+	size_t index = 0;
+	for (const CellPos& position : snake.GetBody())
+	{
+		const SegmentGraphic graphic = GetSegmentGraphic(snake, index++);
 
-	SetSegmentGraphic(SEGMENT_HEAD, snakeAngleWorld, Snake::HEAD_INDEX);
-	SetSegmentGraphic(SEGMENT_BODY, m_segmentGraphics[Snake::HEAD_INDEX].angle, Snake::NECK_INDEX);
-	SetSegmentGraphic(SEGMENT_TAIL, snakeAngleWorld, static_cast<int>( snake.GetLength() ) - 1);
+		const Sprite* pSprite = GetSprite(graphic.type);
+		auto destRect = renderer.WorldToScreen(
+			static_cast<float>(position.x),
+			static_cast<float>(position.y), 1, 1);
+		pSprite->Draw(renderer, destRect, graphic.angle);
+	}
 }
 
-void SnakeGraphics::Update(const Snake& snake, SnakeTurnData* pTurnData)
+SnakeGraphics::SegmentGraphic SnakeGraphics::GetSegmentGraphic(const Snake& snake, size_t index)
 {
-	SetSegmentGraphic(SEGMENT_HEAD, WorldUtil::WorldVecToAngle(snake.GetDirection()), Snake::HEAD_INDEX);
+	const DirectionChain& body = snake.GetBody();
 
-	// Iterate in reverse between the tail and the neck
-	for (size_t i = snake.GetLength() - 2; i > Snake::NECK_INDEX; i--)
+	// The head faces the way the snake is moving
+	if (index == Snake::HEAD_INDEX)
 	{
-		// Take on the graphic of their parent segment
-		m_segmentGraphics[i] = m_segmentGraphics[i - 1];
+		return SegmentGraphic{ SEGMENT_HEAD, ToAngle(snake.GetDirection()) };
 	}
 
-	// Snake turned this update?
-	if (pTurnData)
-	{
-		// Use turn sprite for neck segment
-		SetTurnGraphic(pTurnData->fromParent, pTurnData->fromChild);
-	}
-	else
+	// Every other segment faces towards its parent
+	const Direction toParent = Opposite(body.GetLink(index - 1));
+
+	if (index == body.Size() - 1)
 	{
-		// Use body sprite for the neck segment instead
-		SetSegmentGraphic(SEGMENT_BODY, m_segmentGraphics[Snake::HEAD_INDEX].angle, Snake::NECK_INDEX);
+		return SegmentGraphic{ SEGMENT_TAIL, ToAngle(toParent) };
 	}
 
-	const auto& snakeSegments = snake.GetSegments();
-	int tailIndex = static_cast<int>( snake.GetLength() ) - 1;
-
-	SetSegmentGraphic(
-		SEGMENT_TAIL,
-		WorldUtil::WorldVecToAngle(
-			snakeSegments[tailIndex - 1].position - snakeSegments[tailIndex].position), // Get direction to parent segment
-		tailIndex);
-}
+	// The snake turned on this segment if it was entered from a different
+	// direction to the one it was left in
+	const Direction fromChild = Opposite(body.GetLink(index));
 
-void SnakeGraphics::Render(const SDLAppRenderer& renderer, const Snake& snake) const
-{
-	const auto& segments = snake.GetSegments();
-
-	for (size_t i = 0; i < snake.GetLength(); i++)
+	if (fromChild != toParent)
 	{
-		const Sprite* pSprite = GetSprite(m_segmentGraphics[i].type);
-		auto destRect = renderer.WorldToScreen(segments[i].position.x, segments[i].position.y, 1, 1);
-		pSprite->Draw(renderer, destRect, m_segmentGraphics[i].angle);
+		// The dir from the parent segment is the opposite of the dir towards it
+		return SegmentGraphic{ SEGMENT_TURN, CalculateTurnSpriteRotation(Opposite(toParent), fromChild) };
 	}
-}
 
-void SnakeGraphics::SetSegmentGraphic(SegmentType type, float angle, int index)
-{
-	m_segmentGraphics[index].type = type;
-	m_segmentGraphics[index].angle = angle;
-}
-
-void SnakeGraphics::SetTurnGraphic(const Vector2& fromParent, const Vector2& fromChild)
-{
-	// Calculate correct orientation and set
-	SetSegmentGraphic(SEGMENT_TURN, CalculateTurnSpriteRotation(fromParent, fromChild), Snake::NECK_INDEX);
+	return SegmentGraphic{ SEGMENT_BODY, ToAngle(toParent) };
 }
 
 Sprite* SnakeGraphics::GetSprite(SegmentType type) const
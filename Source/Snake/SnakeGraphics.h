@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Engine/Graphics.h"
+#include "../SnakeCore/WorldTypes.h"
 
 enum SegmentType
 {
@@ -13,34 +14,30 @@ enum SegmentType
 class SDLAppRenderer;
 class Sprite;
 class Snake;
-struct SnakeTurnData;
-struct Vector2;
 
+// Draws a snake. The graphic for each segment is worked out from the
+// directions to its neighbouring segments, so no per-segment state is kept.
 class SnakeGraphics
 {
 public:
-	SnakeGraphics(int maxSegments);
+	SnakeGraphics();
 
-	void Init(const Snake& snake);
-	void Update(const Snake& snake, SnakeTurnData* pTurnData);
 	void Render(const SDLAppRenderer& renderer, const Snake& snake) const;
 
 private:
-	Sprite* GetSprite(SegmentType type) const;
-
-	// Sets a particular segment's graphic data
-	void SetSegmentGraphic(SegmentType type, float angle, int index);
-	void SetTurnGraphic(const Vector2& fromParent, const Vector2& fromChild);
-
 	struct SegmentGraphic
 	{
 		SegmentType type;
 		float angle;
 	};
 
-	std::vector<SegmentGraphic> m_segmentGraphics;
+	// Determines the graphic for the segment at the given index
+	static SegmentGraphic GetSegmentGraphic(const Snake& snake, size_t index);
+
+	Sprite* GetSprite(SegmentType type) const;
+
 	UniqueSpritePtr m_pHead;
 	UniqueSpritePtr m_pTail;
 	UniqueSpritePtr m_pBody;
 	UniqueSpritePtr m_pTurn;
-};
\ No newline at end of file
+};
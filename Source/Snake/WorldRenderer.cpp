@@ -0,0 +1,89 @@
+#include "WorldRenderer.h"
+#include "SnakeGame.h"
+#include "../Engine/Graphics.h"
+#include "../Engine/Math/Vector2.h"
+#include "../Engine/SDLAppRenderer.h"
+#include "../SnakeCore/World.h"
+
+WorldRenderer::WorldRenderer()
+{
+	// Load graphics
+	Graphics::LoadSprite(m_pFood, Assets::SNAKE_FOOD_TEXTURE_PATH);
+}
+
+void WorldRenderer::Render(const SDLAppRenderer& renderer, const World& world) const
+{
+	// Draw the world
+#define GROUND_COLOUR 159, 122, 86, 255
+	renderer.SetDrawColour(GROUND_COLOUR);
+
+	renderer.FillRect(
+		renderer.WorldToScreen(0, 0, static_cast<float>(world.GetWidth()), static_cast<float>(world.GetHeight())));
+
+	// Draw food
+	world.ForEachFood([&](CellPos foodPos)
+	{
+		m_pFood->Draw(
+			renderer,
+			renderer.WorldToScreen(static_cast<float>(foodPos.x), static_cast<float>(foodPos.y), 1, 1),
+			0.0f);
+	});
+
+	m_snakeGraphics.Render(renderer, *world.GetSnake());
+}
+
+void WorldDebugDraw::RenderCellFreeStatus(const World& world, const SDLAppRenderer& renderer)
+{
+	for (int y = 0; y < world.GetHeight(); y++)
+	{
+		for (int x = 0; x < world.GetWidth(); x++)
+		{
+			const Cell cell = world.GetCell(x, y);
+			if (cell.free)
+			{
+				// Free cells are blue
+				renderer.SetDrawColour(0, 0, 32, 255);
+			}
+			else
+			{
+				// Occupied cells are red
+				renderer.SetDrawColour(32, 0, 0, 255);
+			}
+
+			renderer.FillRect(renderer.WorldToScreen(
+				static_cast<float>(x),
+				static_cast<float>(y), 1, 1)
+			);
+		}
+	}
+}
+
+void WorldDebugDraw::RenderGrid(const World& world, const SDLAppRenderer& renderer)
+{
+	// Set grid colour
+	renderer.SetDrawColour(255, 255, 255, 255);
+
+	// Draw row lines
+	for (int i = 0; i <= world.GetHeight(); i++)
+	{
+		Vector2 start(0, 1.0f * i);
+		Vector2 end(1.0f * world.GetWidth(), 1.0f * i);
+
+		renderer.DrawLine(
+			renderer.WorldToScreen(start),
+			renderer.WorldToScreen(end)
+		);
+	}
+
+	// Draw column lines
+	for (int i = 0; i <= world.GetWidth(); i++)
+	{
+		Vector2 start(1.0f * i, 0);
+		Vector2 end(1.0f * i, 1.0f * world.GetHeight());
+
+		renderer.DrawLine(
+			renderer.WorldToScreen(start),
+			renderer.WorldToScreen(end)
+		);
+	}
+}
\ No newline at end of file
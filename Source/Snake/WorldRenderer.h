@@ -0,0 +1,30 @@
+#pragma once
+
+#include "SnakeGraphics.h"
+#include "../Engine/Graphics.h"
+
+class SDLAppRenderer;
+class World;
+
+// Draws a world and everything in it
+class WorldRenderer
+{
+public:
+	WorldRenderer();
+
+	void Render(const SDLAppRenderer& renderer, const World& world) const;
+
+private:
+	SnakeGraphics   m_snakeGraphics;
+	UniqueSpritePtr m_pFood;
+};
+
+class WorldDebugDraw
+{
+public:
+	// Colours each cell in the world according to whether it is occupied
+	static void RenderCellFreeStatus(const World& world, const SDLAppRenderer& renderer);
+
+	// Overlays a grid on top of the world, indicating world and individual cell boundaries
+	static void RenderGrid(const World& world, const SDLAppRenderer& renderer);
+};
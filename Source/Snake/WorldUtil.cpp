@@ -17,10 +17,4 @@ void WorldUtil::DrawRectAtCell(const SDLAppRenderer& renderer, const Vector2& ce
 		rectScale,
 		rectScale)
 	);
-}
-
-float WorldUtil::WorldVecToAngle(const Vector2& v)
-{
-	// Flip the y-coord to work with trig coord system
-	return Math::ToDegrees(atan2f(-v.y, v.x));
 }
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include "Arena.h"
+#include "Snake.h"
+#include "World.h"
+#include "../Engine/Util.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	// Random cells tried when placing food before falling back to counting the free cells
+	constexpr int MAX_FOOD_ATTEMPTS = 16;
+
+	// Room the bodies start with, before growing as the snakes do
+	constexpr size_t INITIAL_BODY_CAPACITY = 16;
+}
+
+ArenaBrain::~ArenaBrain()
+{
+}
+
+Arena::Arena(int width, int height, int numSnakes, int numFood, uint64_t seed)
+	: m_snakes(numSnakes)
+	, m_cells(static_cast<size_t>(width) * height, CELL_FREE)
+	, m_rng(seed)
+	, m_seed(seed)
+	, m_width(width)
+	, m_height(height)
+	, m_foodTarget(numFood)
+	, m_numFood(0)
+	, m_numFree(0)
+	, m_numActive(0)
+	, m_brainDirs(numSnakes)
+	, m_nextCell(numSnakes)
+	, m_moved(numSnakes)
+	, m_ateFood(numSnakes)
+{
+	assert(numSnakes > 0 && numSnakes <= MAX_SNAKES);
+	assert(numFood >= 0);
+
+	// Each snake starts in its own slot, Snake::INITIAL_LENGTH cells wide and a row apart
+	const int slotsPerRow = width / static_cast<int>(Snake::INITIAL_LENGTH + 1);
+	assert(numSnakes <= slotsPerRow * ((height + 1) / 2) && "Arena is too small for this many snakes!");
+	(void)slotsPerRow;
+
+	for (SnakeState& snake : m_snakes)
+	{
+		snake.body   = RingBuffer<CellPos>(INITIAL_BODY_CAPACITY);
+		snake.pBrain = nullptr;
+	}
+	m_died.reserve(numSnakes);
+
+	Reset(seed);
+}
+
+Arena::~Arena()
+{
+	Util::DebugPrint("Arena destroyed\n");
+}
+
+void Arena::Reset(uint64_t seed)
+{
+	m_rng.Seed(seed);
+	m_seed = seed;
+
+	std::fill(m_cells.begin(), m_cells.end(), CELL_FREE);
+	m_numFree   = static_cast<int>(m_cells.size());
+	m_numFood   = 0;
+	m_numActive = GetNumSnakes();
+
+	for (int i = 0; i < GetNumSnakes(); i++)
+	{
+		SnakeState& snake = m_snakes[i];
+		snake.growCounter = 0;
+		snake.dir         = Snake::INITIAL_DIRECTION;
+		snake.status      = STATUS_ACTIVE;
+
+		// Lay the body out in a straight line behind the head
+		const CellPos startPos = CalcStartPos(i);
+		snake.body.Clear();
+		for (size_t j = 0; j < Snake::INITIAL_LENGTH; j++)
+		{
+			const CellPos pos = CellPos{ static_cast<CellCoord>(startPos.x - static_cast<int>(j)), startPos.y };
+			snake.body.PushBack(pos);
+			SetCell(ToCellIndex(pos.x, pos.y), static_cast<CellContents>(CELL_SNAKE + i));
+		}
+	}
+
+	GenerateFood();
+}
+
+void Arena::SetBrain(int snake, ArenaBrain* pBrain)
+{
+	assert(snake >= 0 && snake < GetNumSnakes());
+
+	m_snakes[snake].pBrain = pBrain;
+}
+
+int Arena::Update()
+{
+	for (int i = 0; i < GetNumSnakes(); i++)
+	{
+		const SnakeState& snake = m_snakes[i];
+		const bool think = snake.status == STATUS_ACTIVE && snake.pBrain;
+		m_brainDirs[i] = think ? snake.pBrain->Update(*this, i) : snake.dir;
+	}
+
+	return Update(m_brainDirs.data());
+}
+
+int Arena::Update(const Direction* pInputDirs)
+{
+	assert(pInputDirs);
+
+	const int numSnakes = GetNumSnakes();
+
+	// Growth and movement: works out where each head moves to. Unless the snake is growing,
+	// the tail vacates its cell before any of the heads move.
+	for (int i = 0; i < numSnakes; i++)
+	{
+		SnakeState& snake = m_snakes[i];
+		m_moved[i]   = false;
+		m_ateFood[i] = false;
+
+		if (snake.status != STATUS_ACTIVE) continue;
+
+		const bool grow = snake.growCounter > 0;
+		snake.growCounter -= grow;
+		snake.dir = static_cast<Direction>(pInputDirs[i] & 3);
+
+		const CellPos next = Step(snake.body.Front(), snake.dir);
+		m_nextCell[i] = InBounds(next.x, next.y) ? ToCellIndex(next.x, next.y) : -1;
+
+		if (!grow)
+		{
+			const CellPos tailPos = snake.body.Back();
+			SetCell(ToCellIndex(tailPos.x, tailPos.y), CELL_FREE);
+			snake.body.PopBack();
+		}
+	}
+
+	// Collision: a head dies if it left the board or entered a cell of a body. A cell that a
+	// head has already moved into this update is still that snake's head rather than its body,
+	// and both heads die.
+	for (int i = 0; i < numSnakes; i++)
+	{
+		SnakeState& snake = m_snakes[i];
+		if (snake.status != STATUS_ACTIVE) continue;
+
+		const int cell = m_nextCell[i];
+		const CellContents contents = cell >= 0 ? m_cells[cell] : CELL_FREE;
+
+		if (cell < 0 || contents >= CELL_SNAKE)
+		{
+			const int other = contents - CELL_SNAKE;
+			if (cell >= 0 && m_moved[other] && m_nextCell[other] == cell && m_snakes[other].status == STATUS_ACTIVE)
+			{
+				m_snakes[other].status = STATUS_DEAD;
+				m_died.push_back(other);
+			}
+
+			snake.status = STATUS_DEAD;
+			m_died.push_back(i);
+			continue;
+		}
+
+		// Food is used up by moving onto it, whether or not the snake survives the update
+		if (contents == CELL_FOOD)
+		{
+			m_ateFood[i] = true;
+			m_numFood--;
+		}
+
+		if (snake.body.Size() == snake.body.Capacity())
+		{
+			snake.body.Reserve(snake.body.Capacity() * 2);
+		}
+
+		snake.body.PushFront(CellPos{ static_cast<CellCoord>(cell % m_width), static_cast<CellCoord>(cell / m_width) });
+		SetCell(cell, static_cast<CellContents>(CELL_SNAKE + i));
+		m_moved[i] = true;
+	}
+
+	// Only snakes that survived grow from the food they ate
+	for (int i = 0; i < numSnakes; i++)
+	{
+		if (m_ateFood[i] && m_snakes[i].status == STATUS_ACTIVE)
+		{
+			m_snakes[i].growCounter += World::FOOD_VALUE;
+		}
+	}
+
+	for (int snake : m_died)
+	{
+		RemoveBody(snake);
+	}
+	m_numActive -= static_cast<int>(m_died.size());
+	m_died.clear();
+
+	GenerateFood();
+
+	return m_numActive;
+}
+
+int Arena::GetSnakeAt(int x, int y) const
+{
+	assert(InBounds(x, y));
+
+	const CellContents contents = m_cells[ToCellIndex(x, y)];
+	return contents >= CELL_SNAKE ? contents - CELL_SNAKE : -1;
+}
+
+bool Arena::InBounds(int x, int y) const
+{
+	return (x >= 0 && x < m_width) &&
+		(y >= 0 && y < m_height);
+}
+
+CellPos Arena::CalcStartPos(int snake) const
+{
+	// Spread the snakes evenly over the slots, rather than filling the top rows first
+	const int slotWidth   = static_cast<int>(Snake::INITIAL_LENGTH + 1);
+	const int slotsPerRow = m_width / slotWidth;
+	const int numSlots    = slotsPerRow * ((m_height + 1) / 2);
+	const int slot        = static_cast<int>(static_cast<int64_t>(snake) * numSlots / GetNumSnakes());
+
+	return CellPos{
+		static_cast<CellCoord>((slot % slotsPerRow) * slotWidth + Snake::INITIAL_LENGTH - 1),
+		static_cast<CellCoord>((slot / slotsPerRow) * 2)
+	};
+}
+
+void Arena::GenerateFood()
+{
+	const int numCells = static_cast<int>(m_cells.size());
+
+	while (m_numFood < m_foodTarget && m_numFree > 0)
+	{
+		// Most of the board is usually free, so a few random cells are tried first. Both ways
+		// pick each free cell with the same probability.
+		int cellIndex = -1;
+		for (int attempt = 0; attempt < MAX_FOOD_ATTEMPTS && cellIndex < 0; attempt++)
+		{
+			const int candidate = static_cast<int>(m_rng.NextBounded(static_cast<uint32_t>(numCells)));
+			cellIndex = m_cells[candidate] == CELL_FREE ? candidate : -1;
+		}
+
+		if (cellIndex < 0)
+		{
+			cellIndex = FindNthFreeCell(m_rng.GetInt(0, m_numFree - 1));
+		}
+
+		SetCell(cellIndex, CELL_FOOD);
+		m_numFood++;
+	}
+}
+
+int Arena::FindNthFreeCell(int n) const
+{
+	assert(n >= 0 && n < m_numFree);
+
+	for (size_t i = 0; i < m_cells.size(); i++)
+	{
+		if (m_cells[i] == CELL_FREE && n-- == 0)
+		{
+			return static_cast<int>(i);
+		}
+	}
+
+	assert(false && "Not enough free cells!");
+	return -1;
+}
+
+void Arena::RemoveBody(int snake)
+{
+	// The body is kept, so the snake can still be looked at once it is off the board
+	const CellContents contents = static_cast<CellContents>(CELL_SNAKE + snake);
+	for (const CellPos& pos : m_snakes[snake].body)
+	{
+		const int cellIndex = ToCellIndex(pos.x, pos.y);
+		if (m_cells[cellIndex] == contents)
+		{
+			SetCell(cellIndex, CELL_FREE);
+		}
+	}
+}
+
+void Arena::SetCell(int cellIndex, CellContents contents)
+{
+	CellContents& cell = m_cells[cellIndex];
+	m_numFree += (contents == CELL_FREE) - (cell == CELL_FREE);
+	cell = contents;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "WorldTypes.h"
+#include "../Engine/Math/Pcg32.h"
+#include "../Engine/RingBuffer.h"
+
+#include <cstdint>
+#include <vector>
+
+class Arena;
+
+// Decides how one of the snakes in an arena moves
+class ArenaBrain
+{
+public:
+	virtual ~ArenaBrain();
+
+	// Called once per arena update to pick the direction a snake moves in
+	virtual Direction Update(const Arena& arena, int snake) = 0;
+};
+
+// Many snakes sharing one board, all moving at the same time.
+//
+// Each cell records what is in it: nothing, food, or which snake's body. An update moves every
+// snake that is still alive once, by these rules:
+//  - Tails vacate their cells first, unless the snake is growing, so a head can move into a
+//    cell another snake's tail leaves in the same update (as a snake can with its own tail).
+//  - A head dies if it leaves the board or enters a cell of any snake's body.
+//  - Heads that enter the same cell all die.
+//  - Food a head moves onto is used up, but only a snake that survives the update grows.
+//  - Snakes that die are taken off the board once every snake has moved, so a snake can't
+//    move into a cell a body was in during the same update.
+//
+// Looking up a cell tells whose body it is, so collisions are resolved in time proportional
+// to the number of snakes, however long their bodies are; only a snake dying takes time in
+// proportion to its length. Food is placed in random free cells, topped back up to the
+// arena's amount at the end of each update.
+//
+// Like World, everything random comes from the arena's own generator, so a game is fully
+// determined by its seed and the directions the snakes are given.
+class Arena
+{
+public:
+	Arena(int width, int height, int numSnakes, int numFood, uint64_t seed);
+	~Arena();
+
+	// Starts a new game, with food placed by a generator started from the seed.
+	// The snakes start spread out across the board, all facing the same way.
+	void Reset(uint64_t seed);
+
+	// Gives a snake a brain to move it in Update(). Snakes without one carry on straight.
+	void SetBrain(int snake, ArenaBrain* pBrain);
+
+	// Moves every snake still alive once, in the direction its brain picks.
+	// Returns the number of snakes still alive.
+	int Update();
+
+	// Moves every snake still alive once. pInputDirs holds the direction each snake should
+	// move in, one per snake. Returns the number of snakes still alive.
+	int Update(const Direction* pInputDirs);
+
+	SnakeStatus GetStatus(int snake) const { return static_cast<SnakeStatus>(m_snakes[snake].status); }
+	Direction GetDirection(int snake) const { return m_snakes[snake].dir; }
+	size_t GetLength(int snake)       const { return m_snakes[snake].body.Size(); }
+	int GetGrowCounter(int snake)     const { return m_snakes[snake].growCounter; }
+	CellPos GetHeadPosition(int snake) const { return m_snakes[snake].body.Front(); }
+
+	// Returns the position of a snake's segment, where index 0 is the head
+	CellPos GetSegment(int snake, size_t index) const { return m_snakes[snake].body[index]; }
+
+	// Returns the snake whose body covers the cell at (x, y), or -1 if there is none
+	int GetSnakeAt(int x, int y) const;
+
+	// Returns true if the position is within the arena limits
+	bool InBounds(int x, int y) const;
+
+	// Returns true if the cell at (x, y) holds neither a snake nor food
+	bool IsFree(int x, int y) const { return m_cells[ToCellIndex(x, y)] == CELL_FREE; }
+
+	// Returns true if the cell at (x, y) is holding food
+	bool HasFoodAt(int x, int y) const { return m_cells[ToCellIndex(x, y)] == CELL_FOOD; }
+
+	// Returns the number of snakes still alive
+	int CountActive() const { return m_numActive; }
+
+	int GetNumSnakes() const { return static_cast<int>(m_snakes.size()); }
+	int GetNumFood()   const { return m_numFood; }
+	int GetWidth()     const { return m_width; }
+	int GetHeight()    const { return m_height; }
+	uint64_t GetSeed() const { return m_seed; }
+
+	// Most snakes an arena can hold, as each cell records its snake in 16 bits
+	static constexpr int MAX_SNAKES = UINT16_MAX - 2;
+
+private:
+	// What each cell holds. Cells of a snake's body hold the snake's index plus CELL_SNAKE.
+	typedef uint16_t CellContents;
+	static constexpr CellContents CELL_FREE  = 0;
+	static constexpr CellContents CELL_FOOD  = 1;
+	static constexpr CellContents CELL_SNAKE = 2;
+
+	struct SnakeState
+	{
+		RingBuffer<CellPos> body; // Segment positions, ordered from head to tail
+		ArenaBrain* pBrain;
+		int32_t     growCounter;
+		Direction   dir;
+		uint8_t     status; // SnakeStatus
+	};
+
+	// Works out where a snake starts, so that the snakes are spread evenly over the board
+	CellPos CalcStartPos(int snake) const;
+
+	// Places food in random free cells until there is as much as the arena holds, or no cell is free
+	void GenerateFood();
+
+	// Returns the nth (starting from 0, in row-major order) free cell
+	int FindNthFreeCell(int n) const;
+
+	// Takes a dead snake's body off the board
+	void RemoveBody(int snake);
+
+	void SetCell(int cellIndex, CellContents contents);
+
+	int ToCellIndex(int x, int y) const { return y * m_width + x; }
+
+	std::vector<SnakeState>   m_snakes;
+	std::vector<CellContents> m_cells;
+	Pcg32    m_rng;
+	uint64_t m_seed; // Seed the current game started from
+	int      m_width;
+	int      m_height;
+	int      m_foodTarget; // Food the arena is topped up to
+	int      m_numFood;
+	int      m_numFree;    // Cells holding neither a snake nor food
+	int      m_numActive;
+
+	// Scratch space filled in during Update
+	std::vector<Direction> m_brainDirs;
+	std::vector<int32_t>   m_nextCell; // Cell each head moves into, or -1 if it leaves the board
+	std::vector<uint8_t>   m_moved;    // Set once a snake's head has moved into its new cell
+	std::vector<uint8_t>   m_ateFood;
+	std::vector<int32_t>   m_died;     // Snakes that died this update
+};
@@ -0,0 +1,369 @@
+#pragma once
+
+#include "../Engine/BitGrid.h"
+#include "WorldTypes.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// A snake's body, stored as the positions of its head and tail and the direction from each
+// segment to the one behind it, packed 2 bits to a direction. Like a RingBuffer of positions,
+// segments can be pushed and popped at either end in O(1), but each takes 2 bits rather than
+// a whole CellPos.
+//
+// Any segment can still be looked up in O(1). The directions are kept 32 to a word, and each
+// word keeps an anchor: the position of the segment its first direction leads from. A segment
+// is found from the anchor of its word (or the head, in the word the front is in) by summing
+// the directions in between, which takes a few popcounts however many there are.
+class DirectionChain
+{
+public:
+	typedef uint64_t Word;
+	static constexpr size_t LINKS_PER_WORD = 32;
+
+	class ConstIterator
+	{
+	public:
+		ConstIterator(const DirectionChain* pChain, size_t index, CellPos pos)
+			: m_pChain(pChain)
+			, m_index(index)
+			, m_pos(pos)
+		{
+		}
+
+		const CellPos& operator*()  const { return m_pos; }
+		const CellPos* operator->() const { return &m_pos; }
+
+		// Follows one direction, rather than looking the next segment up
+		ConstIterator& operator++()
+		{
+			if (m_index + 1 < m_pChain->Size())
+			{
+				m_pos = Step(m_pos, m_pChain->GetLink(m_index));
+			}
+			m_index++;
+			return *this;
+		}
+
+		bool operator==(const ConstIterator& rhs) const { return m_index == rhs.m_index; }
+		bool operator!=(const ConstIterator& rhs) const { return m_index != rhs.m_index; }
+
+	private:
+		const DirectionChain* m_pChain;
+		size_t  m_index;
+		CellPos m_pos;
+	};
+
+	DirectionChain(size_t capacity = 0)
+		: m_words(capacity > 1 ? (capacity - 1 + LINKS_PER_WORD - 1) / LINKS_PER_WORD : 0, 0)
+		, m_anchors(m_words.size())
+		, m_head{ 0, 0 }
+		, m_tail{ 0, 0 }
+		, m_front(0)
+		, m_size(0)
+	{
+	}
+
+	// Adds a segment in front of the head, which it must be next to
+	void PushFront(CellPos pos)
+	{
+		if (m_size == 0)
+		{
+			Start(pos);
+			return;
+		}
+
+		PushFrontLink(DirectionBetween(pos, m_head), pos);
+	}
+
+	// Adds a segment one step in front of the head in the given direction. Saves working the
+	// direction out again when the head is moved.
+	void PushFrontStep(Direction dir)
+	{
+		assert(m_size > 0);
+
+		PushFrontLink(Opposite(dir), Step(m_head, dir));
+	}
+
+	// Adds a segment behind the tail, which it must be next to
+	void PushBack(CellPos pos)
+	{
+		if (m_size == 0)
+		{
+			Start(pos);
+			return;
+		}
+
+		PushBackLink(DirectionBetween(m_tail, pos));
+	}
+
+	void PopFront()
+	{
+		assert(m_size > 0);
+
+		if (--m_size > 0)
+		{
+			m_head  = Step(m_head, ReadLink(m_front));
+			m_front = ToPhysical(1);
+		}
+	}
+
+	void PopBack()
+	{
+		assert(m_size > 0);
+
+		if (--m_size > 0)
+		{
+			m_tail = Step(m_tail, Opposite(ReadLink(ToPhysical(m_size - 1))));
+		}
+	}
+
+	void Clear()
+	{
+		m_front = 0;
+		m_size  = 0;
+	}
+
+	// Makes room for at least capacity segments, keeping the ones already held. This takes
+	// time in proportion to the size, as the anchors are worked out again.
+	void Reserve(size_t capacity)
+	{
+		if (capacity <= Capacity()) return;
+
+		DirectionChain chain(capacity);
+		if (m_size == 0)
+		{
+			*this = std::move(chain);
+			return;
+		}
+
+		chain.Start(m_head);
+		for (size_t i = 0; i + 1 < m_size; i++)
+		{
+			chain.PushBackLink(GetLink(i));
+		}
+		*this = std::move(chain);
+	}
+
+	// Returns the position of a segment, where index 0 is the head
+	CellPos operator[](size_t index) const
+	{
+		assert(index < m_size);
+
+		if (index + 1 == m_size) return m_tail;
+
+		const size_t link      = ToPhysical(index);
+		const size_t wordStart = link - link % LINKS_PER_WORD;
+		const Word   word      = m_words[link / LINKS_PER_WORD];
+
+		// The word's anchor is only in use if its first link is in the chain, at or before this one.
+		// Otherwise the front of the chain is in this word, between its first link and this one.
+		const size_t wordStartIndex = wordStart >= m_front ? wordStart - m_front : wordStart + LinkCapacity() - m_front;
+		if (wordStartIndex <= index)
+		{
+			return FollowLinks(m_anchors[link / LINKS_PER_WORD], word, 0, link % LINKS_PER_WORD);
+		}
+		return FollowLinks(m_head, word, m_front % LINKS_PER_WORD, link % LINKS_PER_WORD);
+	}
+
+	// Returns the direction from a segment to the one behind it
+	Direction GetLink(size_t index) const
+	{
+		assert(index + 1 < m_size);
+		return ReadLink(ToPhysical(index));
+	}
+
+	CellPos Front() const { assert(m_size > 0); return m_head; }
+	CellPos Back()  const { assert(m_size > 0); return m_tail; }
+
+	ConstIterator begin() const { return ConstIterator(this, 0, m_head); }
+	ConstIterator end()   const { return ConstIterator(this, m_size, m_tail); }
+
+	size_t Size()     const { return m_size; }
+	bool   Empty()    const { return m_size == 0; }
+	size_t Capacity() const { return LinkCapacity() + 1; } // One more segment than links
+
+	// Returns the number of bytes Pack writes for a body of the given length
+	static size_t GetPackedSize(size_t length) { return length > 0 ? (length - 1 + 3) / 4 : 0; }
+
+	// Writes the directions from head to tail, four to a byte with the lowest bits first.
+	// Together with the head and length, this is all that's needed to rebuild the body.
+	// The words hold the directions in the same order, so they are copied 32 directions at a
+	// time, shifted along by where the front of the ring is.
+	void Pack(uint8_t* pOut) const
+	{
+		const size_t numLinks = m_size > 0 ? m_size - 1 : 0;
+		const size_t numBytes = GetPackedSize(m_size);
+
+		for (size_t first = 0; first < numLinks; first += LINKS_PER_WORD)
+		{
+			Word word = ReadLinks(ToPhysical(first));
+
+			// Directions past the tail are left as zero
+			const size_t numInWord = numLinks - first;
+			if (numInWord < LINKS_PER_WORD)
+			{
+				word &= (Word(1) << (numInWord * 2)) - 1;
+			}
+
+			const size_t byte = first / 4;
+			StoreBytes(word, pOut + byte, numBytes - byte < sizeof(Word) ? numBytes - byte : sizeof(Word));
+		}
+	}
+
+	// Returns one of the directions written by Pack
+	static Direction GetPackedLink(const uint8_t* pPacked, size_t index)
+	{
+		return static_cast<Direction>((pPacked[index / 4] >> ((index % 4) * 2)) & 3);
+	}
+
+	// Replaces the body with one of the given length written by Pack. The directions are copied
+	// a word at a time, and each word's anchor is found from the one before in the same pass.
+	void Unpack(CellPos head, const uint8_t* pPacked, size_t length)
+	{
+		assert(length > 0);
+
+		Clear();
+		Reserve(length);
+		Start(head);
+
+		const size_t numLinks = length - 1;
+		const size_t numBytes = GetPackedSize(length);
+
+		CellPos anchor = head;
+		for (size_t first = 0; first < numLinks; first += LINKS_PER_WORD)
+		{
+			const size_t byte = first / 4;
+			const Word word = LoadBytes(pPacked + byte, numBytes - byte < sizeof(Word) ? numBytes - byte : sizeof(Word));
+
+			const size_t numInWord = numLinks - first < LINKS_PER_WORD ? numLinks - first : LINKS_PER_WORD;
+			m_words[first / LINKS_PER_WORD]   = word;
+			m_anchors[first / LINKS_PER_WORD] = anchor;
+			anchor = FollowLinks(anchor, word, 0, numInWord);
+		}
+
+		m_tail = anchor;
+		m_size = length;
+	}
+
+private:
+	static_assert(DIRECTION_NORTH == 0 && DIRECTION_EAST == 1 && DIRECTION_SOUTH == 2 && DIRECTION_WEST == 3,
+		"FollowLinks counts directions by their values");
+
+	size_t LinkCapacity() const { return m_words.size() * LINKS_PER_WORD; }
+
+	size_t ToPhysical(size_t index) const
+	{
+		const size_t physical = m_front + index;
+		return physical < LinkCapacity() ? physical : physical - LinkCapacity();
+	}
+
+	void Start(CellPos pos)
+	{
+		m_head  = pos;
+		m_tail  = pos;
+		m_front = 0;
+		m_size  = 1;
+	}
+
+	void PushFrontLink(Direction dir, CellPos pos)
+	{
+		assert(m_size < Capacity() && "Direction chain is full!");
+
+		m_front = (m_front == 0 ? LinkCapacity() : m_front) - 1;
+		WriteLink(m_front, dir, pos);
+		m_head = pos;
+		m_size++;
+	}
+
+	void PushBackLink(Direction dir)
+	{
+		assert(m_size > 0 && m_size < Capacity() && "Direction chain is full!");
+
+		WriteLink(ToPhysical(m_size - 1), dir, m_tail);
+		m_tail = Step(m_tail, dir);
+		m_size++;
+	}
+
+	// Returns the 32 links starting from a physical link, carrying on around the ring
+	Word ReadLinks(size_t link) const
+	{
+		const size_t index = link / LINKS_PER_WORD;
+		const size_t shift = (link % LINKS_PER_WORD) * 2;
+		if (shift == 0) return m_words[index];
+
+		const size_t next = index + 1 < m_words.size() ? index + 1 : 0;
+		return (m_words[index] >> shift) | (m_words[next] << (sizeof(Word) * 8 - shift));
+	}
+
+	// Writes the lowest numBytes bytes of a word, lowest first
+	static void StoreBytes(Word word, uint8_t* pOut, size_t numBytes)
+	{
+		for (size_t i = 0; i < numBytes; i++)
+		{
+			pOut[i] = static_cast<uint8_t>(word >> (i * 8));
+		}
+	}
+
+	// Reads a word of which numBytes bytes are stored, lowest first
+	static Word LoadBytes(const uint8_t* pIn, size_t numBytes)
+	{
+		Word word = 0;
+		for (size_t i = 0; i < numBytes; i++)
+		{
+			word |= static_cast<Word>(pIn[i]) << (i * 8);
+		}
+		return word;
+	}
+
+	Direction ReadLink(size_t link) const
+	{
+		return static_cast<Direction>((m_words[link / LINKS_PER_WORD] >> ((link % LINKS_PER_WORD) * 2)) & 3);
+	}
+
+	// Writes the direction leading from the segment at from, which becomes the word's anchor if
+	// this is its first link
+	void WriteLink(size_t link, Direction dir, CellPos from)
+	{
+		Word& word = m_words[link / LINKS_PER_WORD];
+		const size_t shift = (link % LINKS_PER_WORD) * 2;
+		word = (word & ~(Word(3) << shift)) | (Word(dir) << shift);
+
+		if (link % LINKS_PER_WORD == 0)
+		{
+			m_anchors[link / LINKS_PER_WORD] = from;
+		}
+	}
+
+	// Returns pos moved by the directions in the word from link first up to but not including last
+	static CellPos FollowLinks(CellPos pos, Word word, size_t first, size_t last)
+	{
+		const Word fields = LowFieldBits(last) & ~LowFieldBits(first);
+		const Word low    = word & fields;
+		const Word high   = (word >> 1) & fields;
+
+		const int north = Bits::PopCount(fields & ~(low | high));
+		const int east  = Bits::PopCount(low & ~high);
+		const int south = Bits::PopCount(high & ~low);
+		const int west  = Bits::PopCount(low & high);
+
+		return CellPos{ static_cast<CellCoord>(pos.x + east - west), static_cast<CellCoord>(pos.y + south - north) };
+	}
+
+	// The low bit of each of the first numLinks 2-bit fields
+	static Word LowFieldBits(size_t numLinks)
+	{
+		const Word allLowBits = 0x5555555555555555ull;
+		return numLinks >= LINKS_PER_WORD ? allLowBits : ((Word(1) << (numLinks * 2)) - 1) & allLowBits;
+	}
+
+	std::vector<Word>    m_words;   // Directions from each segment to the next, in a ring
+	std::vector<CellPos> m_anchors; // Position of the segment each word's first direction leads from
+	CellPos m_head;
+	CellPos m_tail;
+	size_t  m_front; // Link leading from the head
+	size_t  m_size;  // Number of segments
+};
@@ -0,0 +1,294 @@
+#pragma once
+
+#include "../Engine/BitGrid.h"
+#include "../Engine/Math/Pcg32.h"
+#include "Snake.h"
+#include "World.h"
+#include "WorldTypes.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+// A world whose board size is fixed at compile time, for the sizes that are simulated at scale.
+//
+// The rules are the same as World::Update and Snake::Simulate, and food is placed the same way,
+// so a FixedWorld plays out exactly like a World of the same size started from the same seed and
+// given the same directions. Unlike World, everything is held in fixed-size arrays inside the
+// object: the strides and bounds are constants, loops over the occupancy words have a known trip
+// count, and there is no snake, brain or heap allocation to go through.
+//
+// Like WorldBatch, the snake is given its direction directly. Boards of any other size (or
+// chosen at run time) use World.
+template <int W, int H>
+class FixedWorld
+{
+public:
+	static constexpr int WIDTH     = W;
+	static constexpr int HEIGHT    = H;
+	static constexpr int NUM_CELLS = W * H;
+
+	static_assert(W > 0 && H > 0, "Board must have at least one cell");
+	static_assert(W <= World::MAX_SIZE && H <= World::MAX_SIZE, "Board is larger than worlds can be");
+	static_assert(W / 2 >= static_cast<int>(Snake::INITIAL_LENGTH) - 1, "Board must fit the starting snake");
+	static_assert(NUM_CELLS > static_cast<int>(Snake::INITIAL_LENGTH), "Board must fit the starting snake and its food");
+
+	explicit FixedWorld(uint64_t seed)
+	{
+		Reset(seed);
+	}
+
+	// Starts a new game, with food placed by a generator started from the seed
+	void Reset(uint64_t seed)
+	{
+		m_rng.Seed(seed);
+		m_seed = seed;
+		m_occupied.fill(0);
+
+		const CellPos startPos = Snake::CalcStartPos(W, H);
+
+		m_growCounter = 0;
+		m_dir         = Snake::INITIAL_DIRECTION;
+		m_status      = STATUS_ACTIVE;
+		m_noFoodLeft  = false;
+
+		m_body[0]   = startPos;
+		m_bodyFront = 0;
+		m_length    = 1;
+
+		// Lay out the rest of the starting body behind the head, as Snake::Init does
+		for (size_t i = 1; i < Snake::INITIAL_LENGTH; i++)
+		{
+			const CellPos lastPos = m_body[i - 1];
+			const Direction segmentDir = (i == 1) ? m_dir : DirectionBetween(lastPos, m_body[i - 2]);
+
+			m_body[i] = Step(lastPos, Opposite(segmentDir));
+			m_length++;
+		}
+
+		for (int i = 0; i < m_length; i++)
+		{
+			OccupyCell(ToCellIndex(m_body[i].x, m_body[i].y));
+		}
+
+		GenerateFood();
+	}
+
+	// Moves the snake one cell in the given direction. Once the game is over, nothing changes
+	// and the final status is returned.
+	SnakeStatus Update(Direction inputDir)
+	{
+		if (m_status != STATUS_ACTIVE)
+		{
+			return static_cast<SnakeStatus>(m_status);
+		}
+
+		// Check if the player has eaten all food
+		if (m_noFoodLeft)
+		{
+			m_status = STATUS_DONE;
+			return STATUS_DONE;
+		}
+
+		const bool grow = m_growCounter > 0;
+		m_growCounter -= grow;
+		m_dir = inputDir;
+
+		const CellPos head = Step(GetHeadPosition(), inputDir);
+
+		// Unless the snake is growing, the tail vacates its cell before the head moves
+		if (!grow)
+		{
+			const CellPos tailPos = GetSegment(m_length - 1);
+			FreeCell(ToCellIndex(tailPos.x, tailPos.y));
+			m_length--;
+		}
+
+		PushHead(head);
+
+		// The head dies if it left the world, or entered an occupied cell that isn't the food
+		const int cell = ToCellIndex(head.x, head.y);
+		if (!InBounds(head.x, head.y) || (IsOccupied(cell) && cell != m_foodCell))
+		{
+			m_status = STATUS_DEAD;
+			return STATUS_DEAD;
+		}
+
+		OccupyCell(cell);
+
+		if (cell == m_foodCell)
+		{
+			m_growCounter += World::FOOD_VALUE;
+			GenerateFood();
+		}
+
+		return STATUS_ACTIVE;
+	}
+
+	// Saves the state of the current game apart from the snake's body, in the same form as World
+	void GetState(WorldState& outState) const
+	{
+		outState.rng          = m_rng;
+		outState.foodPosition = GetFoodPosition();
+		outState.direction    = m_dir;
+		outState.growCounter  = m_growCounter;
+		outState.noFoodLeft   = m_noFoodLeft;
+		outState.dead         = m_status == STATUS_DEAD;
+	}
+
+	// Copies the current game into a World of the same size, so it can be carried on there
+	void CopyTo(World& world) const
+	{
+		assert(world.GetWidth() == W && world.GetHeight() == H);
+
+		CellPos segments[NUM_CELLS];
+		for (int i = 0; i < m_length; i++)
+		{
+			segments[i] = GetSegment(i);
+		}
+
+		WorldState state;
+		GetState(state);
+		world.SetState(state, segments, m_length);
+	}
+
+	SnakeStatus GetStatus()    const { return static_cast<SnakeStatus>(m_status); }
+	CellPos GetHeadPosition()  const { return m_body[m_bodyFront]; }
+	Direction GetDirection()   const { return m_dir; }
+	size_t GetLength()         const { return static_cast<size_t>(m_length); }
+	bool IsGrowing()           const { return m_growCounter > 0; }
+	int GetGrowCounter()       const { return m_growCounter; }
+	uint64_t GetSeed()         const { return m_seed; }
+
+	CellPos GetFoodPosition() const
+	{
+		assert(m_foodCell >= 0);
+
+		return CellPos{ static_cast<CellCoord>(m_foodCell % W), static_cast<CellCoord>(m_foodCell / W) };
+	}
+
+	// Returns the position of a segment, where index 0 is the head
+	CellPos GetSegment(int index) const
+	{
+		assert(index >= 0 && index < m_length);
+
+		const int physical = m_bodyFront + index;
+		return m_body[physical < NUM_CELLS ? physical : physical - NUM_CELLS];
+	}
+
+	// Returns true if the cell at (x, y) is not occupied by the snake or food
+	bool IsFree(int x, int y) const
+	{
+		assert(InBounds(x, y));
+
+		return !IsOccupied(ToCellIndex(x, y));
+	}
+
+	// Returns true if the cell at (x, y) is holding the food
+	bool HasFoodAt(int x, int y) const
+	{
+		assert(InBounds(x, y));
+
+		return ToCellIndex(x, y) == m_foodCell;
+	}
+
+	// Returns true if the position is within the world limits.
+	// Negative coordinates wrap to large unsigned values, so one compare per axis covers both bounds.
+	static constexpr bool InBounds(int x, int y)
+	{
+		return static_cast<unsigned>(x) < static_cast<unsigned>(W) &&
+			static_cast<unsigned>(y) < static_cast<unsigned>(H);
+	}
+
+	static constexpr int GetWidth()  { return W; }
+	static constexpr int GetHeight() { return H; }
+
+private:
+	typedef BitGrid::Word Word;
+	static constexpr int BITS_PER_WORD = BitGrid::BITS_PER_WORD;
+	static constexpr int NUM_WORDS     = (NUM_CELLS + BITS_PER_WORD - 1) / BITS_PER_WORD;
+
+	static constexpr int ToCellIndex(int x, int y) { return y * W + x; }
+
+	void GenerateFood()
+	{
+		const int numFree = NUM_CELLS - m_length;
+
+		// No more food can be generated
+		m_noFoodLeft = numFree == 0;
+		if (m_noFoodLeft) return;
+
+		// Select a random free cell and place food there, counting cells as World does
+		const int cell = FindNthFreeCell(m_rng.GetInt(0, numFree - 1));
+
+		m_foodCell = cell;
+		OccupyCell(cell);
+	}
+
+	// Returns the nth (starting from 0, in row-major order) free cell
+	int FindNthFreeCell(int n) const
+	{
+		assert(n >= 0);
+
+		// While the snake has fewer cells than the board has words, sorting them is quicker than
+		// scanning the words. The cell found is the same either way.
+		if (m_length < NUM_WORDS && static_cast<size_t>(m_length) <= World::MAX_SORTED_SNAKE_LENGTH)
+		{
+			int64_t occupiedCells[World::MAX_SORTED_SNAKE_LENGTH];
+			for (int i = 0; i < m_length; i++)
+			{
+				const CellPos pos = GetSegment(i);
+				occupiedCells[i] = ToCellIndex(pos.x, pos.y);
+			}
+			return static_cast<int>(World::FindNthFreeCell(n, occupiedCells, m_length));
+		}
+
+		const int cell = static_cast<int>(Bits::FindNthClear(m_occupied.data(), NUM_WORDS, NUM_CELLS, n));
+		assert(cell >= 0 && "Not enough free cells!");
+		return cell;
+	}
+
+	// Pushes a new head onto the front of the body
+	void PushHead(CellPos pos)
+	{
+		assert(m_length < NUM_CELLS && "Snake body is full!");
+
+		m_bodyFront = (m_bodyFront == 0 ? NUM_CELLS : m_bodyFront) - 1;
+		m_body[m_bodyFront] = pos;
+		m_length++;
+	}
+
+	void OccupyCell(int cell)
+	{
+		assert(cell >= 0 && cell < NUM_CELLS);
+
+		m_occupied[cell / BITS_PER_WORD] |= Word(1) << (cell % BITS_PER_WORD);
+	}
+
+	void FreeCell(int cell)
+	{
+		assert(cell >= 0 && cell < NUM_CELLS);
+
+		m_occupied[cell / BITS_PER_WORD] &= ~(Word(1) << (cell % BITS_PER_WORD));
+	}
+
+	bool IsOccupied(int cell) const
+	{
+		assert(cell >= 0 && cell < NUM_CELLS);
+
+		return (m_occupied[cell / BITS_PER_WORD] >> (cell % BITS_PER_WORD)) & 1;
+	}
+
+	std::array<CellPos, NUM_CELLS> m_body;     // Ring buffer of segment positions, ordered from head to tail
+	std::array<Word, NUM_WORDS>    m_occupied; // A set bit marks an occupied cell
+	Pcg32     m_rng;
+	uint64_t  m_seed; // Seed the current game started from
+	int       m_bodyFront; // Index into m_body holding the head
+	int       m_length;
+	int       m_growCounter;
+	int       m_foodCell; // Cell that is holding the food
+	Direction m_dir;
+	uint8_t   m_status; // SnakeStatus
+	bool      m_noFoodLeft;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Snake.h"
+#include "SnakeBrain.h"
+#include "WorldTypes.h"
+
+// Moves the snake in the direction read from a replay
+class ReplayBrain : public SnakeBrain
+{
+public:
+	ReplayBrain()
+		: m_dir(DIRECTION_NORTH)
+		, m_hasInput(false)
+	{
+	}
+
+	void SetDirection(Direction dir) { m_dir = dir; m_hasInput = true; }
+
+	// Once the recorded input runs out the snake is left where it is
+	void ClearDirection() { m_hasInput = false; }
+
+	virtual void Update(Snake* pSnake) override
+	{
+		if (m_hasInput)
+		{
+			pSnake->Simulate(m_dir);
+		}
+	}
+
+private:
+	Direction m_dir;
+	bool      m_hasInput;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "WorldTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Layout of a replay file. A game is fully determined by its board size, seed and the
+// direction the snake moved in each tick, so that is all that is needed to play it back:
+//
+//   Header   "SNKR", version byte, width and height (varints), seed (8 bytes, little-endian),
+//            keyframe interval in ticks (varint, 0 if there are no keyframes)
+//   Input    Runs of ticks spent moving in the same direction, each a varint of
+//            (numTicks << 2) | direction. A run of 0 ticks north marks the end of the input.
+//            A run of 0 ticks east is followed by a keyframe (see below): its size as a varint,
+//            then the keyframe itself.
+//   Footer   Final SnakeStatus (1 byte), final snake length and number of ticks (varints)
+//   Index    One entry per keyframe, in tick order: the tick it was taken after and the file
+//            offset of its marker run (8 bytes each, little-endian)
+//   Trailer  File offset of the footer and number of index entries (8 bytes each,
+//            little-endian), then "SNKI"
+//
+// Keyframes are taken every keyframe interval ticks while the snake is alive, and hold the
+// state of the world after that tick (see ReplayKeyframe.h). The trailer has a fixed size, so
+// a reader can find the index and footer from the end of the file without reading the input,
+// then jump to any tick by restoring the keyframe before it and playing back the input from
+// there. Version 1 files have no keyframe interval, index or trailer.
+//
+// Varints store 7 bits per byte, lowest bits first, with the top bit set on every byte but
+// the last. A run of up to 31 ticks in one direction therefore takes a single byte.
+namespace ReplayFormat
+{
+	constexpr uint8_t MAGIC[] = { 'S', 'N', 'K', 'R' };
+	constexpr uint8_t VERSION = 2;
+
+	constexpr uint8_t TRAILER_MAGIC[] = { 'S', 'N', 'K', 'I' };
+	constexpr size_t INDEX_ENTRY_SIZE = 16;
+	constexpr size_t TRAILER_SIZE     = 16 + sizeof(TRAILER_MAGIC);
+
+	// Ticks between keyframes unless a writer is told otherwise. Seeking plays back at most
+	// this many ticks after restoring a keyframe.
+	constexpr uint64_t DEFAULT_KEYFRAME_INTERVAL = 1024;
+
+	constexpr size_t MAX_VARINT_SIZE = 10;
+
+	// Packs a run of ticks in one direction into the value stored in the input stream
+	constexpr uint64_t MakeRun(Direction dir, uint64_t numTicks) { return (numTicks << 2) | dir; }
+
+	constexpr Direction GetRunDirection(uint64_t run) { return static_cast<Direction>(run & 3); }
+	constexpr uint64_t GetRunTicks(uint64_t run)      { return run >> 2; }
+
+	// Runs of no ticks don't move the snake, so they are used to mark other records
+	constexpr uint64_t END_OF_INPUT    = MakeRun(DIRECTION_NORTH, 0);
+	constexpr uint64_t KEYFRAME_MARKER = MakeRun(DIRECTION_EAST, 0);
+
+	// Writes value as a varint to pOut, which must have room for MAX_VARINT_SIZE bytes.
+	// Returns the number of bytes written.
+	inline size_t EncodeVarint(uint64_t value, uint8_t* pOut)
+	{
+		size_t size = 0;
+		while (value >= 0x80)
+		{
+			pOut[size++] = static_cast<uint8_t>(value | 0x80);
+			value >>= 7;
+		}
+		pOut[size++] = static_cast<uint8_t>(value);
+		return size;
+	}
+
+	// Reads a varint starting at pData, advancing it past the varint.
+	// Returns false if the varint runs past pEnd or is too long.
+	inline bool DecodeVarint(const uint8_t*& pData, const uint8_t* pEnd, uint64_t& outValue)
+	{
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64 && pData < pEnd; shift += 7)
+		{
+			const uint8_t byte = *pData++;
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+			if ((byte & 0x80) == 0)
+			{
+				outValue = value;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Fixed-size values are stored in little-endian order so files read the same on any machine
+	inline void WriteUint64(uint64_t value, uint8_t* pOut)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			pOut[i] = static_cast<uint8_t>(value >> (i * 8));
+		}
+	}
+
+	inline uint64_t ReadUint64(const uint8_t* pData)
+	{
+		uint64_t value = 0;
+		for (int i = 0; i < 8; i++)
+		{
+			value |= static_cast<uint64_t>(pData[i]) << (i * 8);
+		}
+		return value;
+	}
+}
@@ -0,0 +1,115 @@
+#include "ReplayKeyframe.h"
+#include "ReplayFormat.h"
+#include "World.h"
+#include "../Engine/BitGrid.h"
+
+#include <cassert>
+
+namespace ReplayKeyframe
+{
+	namespace
+	{
+		constexpr uint8_t FLAG_NO_FOOD_LEFT = 1 << 2;
+
+		void AppendVarint(uint64_t value, std::vector<uint8_t>& out)
+		{
+			uint8_t bytes[ReplayFormat::MAX_VARINT_SIZE];
+			const size_t size = ReplayFormat::EncodeVarint(value, bytes);
+			out.insert(out.end(), bytes, bytes + size);
+		}
+
+		void AppendUint64(uint64_t value, std::vector<uint8_t>& out)
+		{
+			uint8_t bytes[8];
+			ReplayFormat::WriteUint64(value, bytes);
+			out.insert(out.end(), bytes, bytes + 8);
+		}
+	}
+
+	void Write(const World& world, std::vector<uint8_t>& out)
+	{
+		const Snake* pSnake = world.GetSnake();
+		assert(!pSnake->IsDead() && "Keyframes can't hold a snake that has left the world!");
+
+		WorldState state;
+		world.GetState(state);
+
+		AppendUint64(state.rng.GetState(), out);
+		AppendUint64(state.rng.GetIncrement(), out);
+		out.push_back(static_cast<uint8_t>(state.direction | (state.noFoodLeft ? FLAG_NO_FOOD_LEFT : 0)));
+
+		AppendVarint(static_cast<uint64_t>(state.growCounter), out);
+		AppendVarint(static_cast<uint64_t>(state.foodPosition.y) * world.GetWidth() + state.foodPosition.x, out);
+
+		const DirectionChain& body = pSnake->GetBody();
+		AppendVarint(body.Size(), out);
+		AppendVarint(static_cast<uint64_t>(body.Front().x), out);
+		AppendVarint(static_cast<uint64_t>(body.Front().y), out);
+
+		// The body's directions are written as the chain packs them, four to a byte
+		const size_t packedStart = out.size();
+		out.resize(packedStart + DirectionChain::GetPackedSize(body.Size()));
+		body.Pack(out.data() + packedStart);
+	}
+
+	bool Read(const uint8_t* pData, size_t size, World& world)
+	{
+		const uint8_t* pEnd = pData + size;
+
+		if (size < 17) return false;
+
+		WorldState state;
+		const uint64_t rngState     = ReplayFormat::ReadUint64(pData);
+		const uint64_t rngIncrement = ReplayFormat::ReadUint64(pData + 8);
+		state.rng.SetState(rngState, rngIncrement);
+		pData += 16;
+
+		const uint8_t flags = *pData++;
+		state.direction  = static_cast<Direction>(flags & 3);
+		state.noFoodLeft = (flags & FLAG_NO_FOOD_LEFT) != 0;
+		state.dead       = false;
+
+		const uint64_t numCells = static_cast<uint64_t>(world.GetWidth()) * world.GetHeight();
+
+		uint64_t growCounter, foodCell, length, headX, headY;
+		if (!ReplayFormat::DecodeVarint(pData, pEnd, growCounter) || growCounter > numCells * World::FOOD_VALUE ||
+			!ReplayFormat::DecodeVarint(pData, pEnd, foodCell) || foodCell >= numCells ||
+			!ReplayFormat::DecodeVarint(pData, pEnd, length) || length == 0 || length > numCells ||
+			!ReplayFormat::DecodeVarint(pData, pEnd, headX) || headX >= static_cast<uint64_t>(world.GetWidth()) ||
+			!ReplayFormat::DecodeVarint(pData, pEnd, headY) || headY >= static_cast<uint64_t>(world.GetHeight()))
+			return false;
+
+		state.growCounter  = static_cast<int32_t>(growCounter);
+		state.foodPosition = CellPos{
+			static_cast<CellCoord>(foodCell % world.GetWidth()),
+			static_cast<CellCoord>(foodCell / world.GetWidth())
+		};
+
+		if (static_cast<uint64_t>(pEnd - pData) != DirectionChain::GetPackedSize(static_cast<size_t>(length)))
+			return false;
+
+		std::vector<CellPos> segments(static_cast<size_t>(length));
+		segments[0] = CellPos{ static_cast<CellCoord>(headX), static_cast<CellCoord>(headY) };
+
+		// A living snake covers a different cell with each segment, so a body that runs into
+		// itself is rejected before it can reach the world
+		BitGrid bodyCells(world.GetWidth(), world.GetHeight());
+		bodyCells.Set(segments[0].x, segments[0].y);
+
+		for (size_t i = 1; i < segments.size(); i++)
+		{
+			segments[i] = Step(segments[i - 1], DirectionChain::GetPackedLink(pData, i - 1));
+
+			if (!world.InBounds(segments[i].x, segments[i].y) || !bodyCells.Set(segments[i].x, segments[i].y))
+				return false;
+		}
+
+		// Food is never placed under the body. Once all of it is gone, the position is where the
+		// last piece was eaten, under the head.
+		if (!state.noFoodLeft && bodyCells.Get(state.foodPosition.x, state.foodPosition.y))
+			return false;
+
+		world.SetState(state, segments.data(), segments.size());
+		return true;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class World;
+
+// Compact snapshots of a world's state, stored in replays so playback can start mid-game.
+//
+// A keyframe holds the generator state, the snake's direction and grow counter, the food
+// cell and the snake's body. The body is stored as its head position followed by the
+// direction from each segment to the next, packed 2 bits each, so a snake covering a
+// 100x100 board takes about 2.5KB. Which cells are occupied isn't stored, as it follows
+// from the body and the food.
+//
+// Layout: generator state and increment (8 bytes each, little-endian), direction (2 bits)
+// and no-food-left flag (bit 2) in one byte, then varints of the grow counter, the food
+// cell index, the snake length and the head's x and y, then the packed body directions.
+namespace ReplayKeyframe
+{
+	// Appends a keyframe of the world's current state to out. The snake must be alive.
+	void Write(const World& world, std::vector<uint8_t>& out);
+
+	// Carries on the world's game from a keyframe taken on a board of the same size.
+	// Returns false if the keyframe is malformed or holds a state no game can reach (a body
+	// that crosses itself, or food under the body), in which case the world is left untouched.
+	bool Read(const uint8_t* pData, size_t size, World& world);
+}
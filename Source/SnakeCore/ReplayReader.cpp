@@ -0,0 +1,234 @@
+#include "ReplayReader.h"
+#include "ReplayFormat.h"
+#include "World.h"
+
+#include <cassert>
+#include <cstring>
+
+ReplayReader::ReplayReader()
+	: m_pBegin(nullptr)
+	, m_pData(nullptr)
+	, m_pEnd(nullptr)
+	, m_pInput(nullptr)
+	, m_pIndex(nullptr)
+	, m_numKeyframes(0)
+	, m_keyframeInterval(0)
+	, m_width(0)
+	, m_height(0)
+	, m_seed(0)
+	, m_recordedStatus(STATUS_ACTIVE)
+	, m_recordedLength(0)
+	, m_recordedNumTicks(0)
+	, m_valid(false)
+	, m_ended(false)
+{
+}
+
+bool ReplayReader::Open(const uint8_t* pData, size_t size)
+{
+	m_pBegin = pData;
+	m_pData  = pData;
+	m_pEnd   = pData + size;
+	m_pIndex = nullptr;
+	m_numKeyframes     = 0;
+	m_keyframeInterval = 0;
+	m_valid = true;
+	m_ended = false;
+
+	constexpr size_t MAGIC_SIZE = sizeof(ReplayFormat::MAGIC);
+	constexpr size_t SEED_SIZE  = 8;
+
+	if (size < MAGIC_SIZE + 1 || memcmp(m_pData, ReplayFormat::MAGIC, MAGIC_SIZE) != 0)
+		return Fail();
+	m_pData += MAGIC_SIZE;
+
+	// Version 1 replays are the same, without keyframes
+	const uint8_t version = *m_pData++;
+	if (version == 0 || version > ReplayFormat::VERSION)
+		return Fail();
+
+	constexpr uint64_t MAX_SIZE = World::MAX_SIZE;
+	uint64_t width, height;
+	if (!ReplayFormat::DecodeVarint(m_pData, m_pEnd, width) || width == 0 || width > MAX_SIZE)
+		return Fail();
+	if (!ReplayFormat::DecodeVarint(m_pData, m_pEnd, height) || height == 0 || height > MAX_SIZE)
+		return Fail();
+	m_width  = static_cast<int>(width);
+	m_height = static_cast<int>(height);
+
+	if (static_cast<size_t>(m_pEnd - m_pData) < SEED_SIZE)
+		return Fail();
+
+	m_seed = ReplayFormat::ReadUint64(m_pData);
+	m_pData += SEED_SIZE;
+
+	if (version >= 2)
+	{
+		if (!ReplayFormat::DecodeVarint(m_pData, m_pEnd, m_keyframeInterval))
+			return Fail();
+
+		m_pInput = m_pData;
+		return ReadTrailer();
+	}
+
+	m_pInput = m_pData;
+	return true;
+}
+
+bool ReplayReader::NextRun(Direction& outDir, uint64_t& outNumTicks)
+{
+	if (!m_valid || m_ended) return false;
+
+	for (;;)
+	{
+		uint64_t run;
+		if (!ReplayFormat::DecodeVarint(m_pData, m_pEnd, run))
+			return Fail();
+
+		if (run == ReplayFormat::END_OF_INPUT)
+		{
+			m_ended = true;
+
+			// The footer of a replay with an index has already been read
+			if (!HasIndex())
+			{
+				ReadFooter(m_pData);
+			}
+			return false;
+		}
+
+		if (run == ReplayFormat::KEYFRAME_MARKER)
+		{
+			uint64_t keyframeSize;
+			if (!ReplayFormat::DecodeVarint(m_pData, m_pEnd, keyframeSize) ||
+				keyframeSize > static_cast<uint64_t>(m_pEnd - m_pData))
+				return Fail();
+
+			m_pData += keyframeSize;
+			continue;
+		}
+
+		if (ReplayFormat::GetRunTicks(run) == 0)
+			return Fail();
+
+		outDir      = ReplayFormat::GetRunDirection(run);
+		outNumTicks = ReplayFormat::GetRunTicks(run);
+		return true;
+	}
+}
+
+void ReplayReader::Rewind()
+{
+	assert(m_pInput);
+
+	m_pData = m_pInput;
+	m_ended = false;
+}
+
+bool ReplayReader::SeekToKeyframe(size_t index, const uint8_t*& outKeyframe, size_t& outSize)
+{
+	assert(index < m_numKeyframes);
+
+	if (!m_valid) return false;
+
+	const uint64_t offset = ReplayFormat::ReadUint64(m_pIndex + index * ReplayFormat::INDEX_ENTRY_SIZE + 8);
+	if (offset < static_cast<uint64_t>(m_pInput - m_pBegin) || offset >= static_cast<uint64_t>(m_pIndex - m_pBegin))
+		return Fail();
+
+	m_pData = m_pBegin + offset;
+	m_ended = false;
+
+	uint64_t marker, keyframeSize;
+	if (!ReplayFormat::DecodeVarint(m_pData, m_pEnd, marker) || marker != ReplayFormat::KEYFRAME_MARKER ||
+		!ReplayFormat::DecodeVarint(m_pData, m_pEnd, keyframeSize) ||
+		keyframeSize > static_cast<uint64_t>(m_pEnd - m_pData))
+		return Fail();
+
+	outKeyframe = m_pData;
+	outSize     = static_cast<size_t>(keyframeSize);
+	m_pData += keyframeSize;
+	return true;
+}
+
+size_t ReplayReader::FindKeyframe(uint64_t tick) const
+{
+	// Find the first keyframe taken after the tick, the one before it is the answer
+	size_t first = 0;
+	size_t count = m_numKeyframes;
+	while (count > 0)
+	{
+		const size_t half = count / 2;
+		if (GetKeyframeTick(first + half) <= tick)
+		{
+			first += half + 1;
+			count -= half + 1;
+		}
+		else
+		{
+			count = half;
+		}
+	}
+
+	return first > 0 ? first - 1 : m_numKeyframes;
+}
+
+uint64_t ReplayReader::GetKeyframeTick(size_t index) const
+{
+	assert(index < m_numKeyframes);
+
+	return ReplayFormat::ReadUint64(m_pIndex + index * ReplayFormat::INDEX_ENTRY_SIZE);
+}
+
+bool ReplayReader::ReadFooter(const uint8_t* pData)
+{
+	if (pData >= m_pEnd)
+		return Fail();
+
+	const uint8_t status = *pData++;
+	if (status > STATUS_DEAD)
+		return Fail();
+	m_recordedStatus = static_cast<SnakeStatus>(status);
+
+	uint64_t length;
+	if (!ReplayFormat::DecodeVarint(pData, m_pEnd, length) ||
+		!ReplayFormat::DecodeVarint(pData, m_pEnd, m_recordedNumTicks))
+		return Fail();
+	m_recordedLength = static_cast<size_t>(length);
+
+	return true;
+}
+
+bool ReplayReader::ReadTrailer()
+{
+	constexpr size_t MAGIC_SIZE = sizeof(ReplayFormat::TRAILER_MAGIC);
+
+	const size_t size = static_cast<size_t>(m_pEnd - m_pInput);
+	if (size < ReplayFormat::TRAILER_SIZE)
+		return Fail();
+
+	const uint8_t* pTrailer = m_pEnd - ReplayFormat::TRAILER_SIZE;
+	if (memcmp(pTrailer + 16, ReplayFormat::TRAILER_MAGIC, MAGIC_SIZE) != 0)
+		return Fail();
+
+	const uint64_t footerOffset = ReplayFormat::ReadUint64(pTrailer);
+	const uint64_t numKeyframes = ReplayFormat::ReadUint64(pTrailer + 8);
+
+	// The index sits between the footer and the trailer
+	const uint64_t maxKeyframes = (size - ReplayFormat::TRAILER_SIZE) / ReplayFormat::INDEX_ENTRY_SIZE;
+	if (numKeyframes > maxKeyframes)
+		return Fail();
+
+	m_numKeyframes = static_cast<size_t>(numKeyframes);
+	m_pIndex = pTrailer - m_numKeyframes * ReplayFormat::INDEX_ENTRY_SIZE;
+
+	if (footerOffset < static_cast<uint64_t>(m_pInput - m_pBegin) || footerOffset >= static_cast<uint64_t>(m_pIndex - m_pBegin))
+		return Fail();
+
+	return ReadFooter(m_pBegin + footerOffset);
+}
+
+bool ReplayReader::Fail()
+{
+	m_valid = false;
+	return false;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "WorldTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Reads a replay (see ReplayFormat.h) from memory, one run of ticks at a time.
+// Only the parts that are asked for are read, so the data can be a mapped file of any size.
+class ReplayReader
+{
+public:
+	ReplayReader();
+
+	// Reads the header, and the footer and index if the replay has them.
+	// Returns false if the data isn't a replay this version can read.
+	bool Open(const uint8_t* pData, size_t size);
+
+	// Reads the next run of ticks spent moving in one direction, skipping over keyframes.
+	// Returns false once the input has ended, after which the footer can be read, or
+	// if the data is malformed (see IsValid).
+	bool NextRun(Direction& outDir, uint64_t& outNumTicks);
+
+	// Moves back to the start of the input
+	void Rewind();
+
+	// Moves to just after a keyframe, so NextRun carries on from the tick it was taken after.
+	// outKeyframe and outSize are set to the keyframe's data (see ReplayKeyframe.h).
+	// Returns false if the data is malformed.
+	bool SeekToKeyframe(size_t index, const uint8_t*& outKeyframe, size_t& outSize);
+
+	// Returns the last keyframe taken after a tick no later than the one given,
+	// or GetNumKeyframes() if there is none. Binary searches the index.
+	size_t FindKeyframe(uint64_t tick) const;
+
+	// Returns false if the data was found to be malformed
+	bool IsValid() const { return m_valid; }
+
+	int GetWidth()      const { return m_width; }
+	int GetHeight()     const { return m_height; }
+	uint64_t GetSeed()  const { return m_seed; }
+
+	// Returns true if the replay has a footer and keyframe index that were read by Open
+	bool HasIndex() const { return m_pIndex != nullptr; }
+
+	uint64_t GetKeyframeInterval() const { return m_keyframeInterval; }
+	size_t GetNumKeyframes()       const { return m_numKeyframes; }
+
+	// Returns the tick a keyframe was taken after
+	uint64_t GetKeyframeTick(size_t index) const;
+
+	// Result of the game as recorded. Only valid once NextRun has returned false,
+	// or straight after Open if the replay has an index.
+	SnakeStatus GetRecordedStatus() const { return m_recordedStatus; }
+	size_t GetRecordedLength()      const { return m_recordedLength; }
+	uint64_t GetRecordedNumTicks()  const { return m_recordedNumTicks; }
+
+private:
+	// Reads the footer at pData, which must be before the end of the data
+	bool ReadFooter(const uint8_t* pData);
+
+	// Reads the trailer and footer of a replay that has an index
+	bool ReadTrailer();
+
+	// Marks the replay as malformed. Always returns false.
+	bool Fail();
+
+	const uint8_t* m_pBegin;
+	const uint8_t* m_pData;
+	const uint8_t* m_pEnd;
+	const uint8_t* m_pInput;  // Start of the input
+	const uint8_t* m_pIndex;  // Start of the keyframe index, if there is one
+	size_t         m_numKeyframes;
+	uint64_t       m_keyframeInterval;
+	int            m_width;
+	int            m_height;
+	uint64_t       m_seed;
+	SnakeStatus    m_recordedStatus;
+	size_t         m_recordedLength;
+	uint64_t       m_recordedNumTicks;
+	bool           m_valid;
+	bool           m_ended; // Reached the end of the input
+};
@@ -0,0 +1,75 @@
+#include "ReplayRunner.h"
+#include "ReplayBrain.h"
+
+ReplayRunner::ReplayRunner()
+	: m_pBrain(std::make_unique<ReplayBrain>())
+	, m_status(STATUS_ACTIVE)
+	, m_length(0)
+	, m_numTicks(0)
+	, m_tickAllocations{}
+{
+}
+
+ReplayRunner::~ReplayRunner()
+{
+}
+
+bool ReplayRunner::Run(const uint8_t* pData, size_t size)
+{
+	if (!m_reader.Open(pData, size))
+		return false;
+
+	const int width  = m_reader.GetWidth();
+	const int height = m_reader.GetHeight();
+
+	if (m_pWorld && m_pWorld->GetWidth() == width && m_pWorld->GetHeight() == height)
+	{
+		m_pWorld->Reset(m_reader.GetSeed());
+	}
+	else
+	{
+		m_pWorld = std::make_unique<World>(width, height, m_reader.GetSeed());
+	}
+
+	m_status   = STATUS_ACTIVE;
+	m_numTicks = 0;
+
+	const AllocationScope tickAllocations;
+
+	Direction dir;
+	uint64_t numTicks;
+	while (m_reader.NextRun(dir, numTicks))
+	{
+		// Any input left once the game is over is counted as a mismatch by Matches
+		if (m_status == STATUS_ACTIVE)
+		{
+			uint64_t numUpdates;
+			m_status = m_pWorld->UpdateStraight(dir, numTicks, numUpdates);
+			m_numTicks += numUpdates;
+		}
+	}
+
+	if (!m_reader.IsValid())
+		return false;
+
+	// A game that ate the last food is only reported as won on the update after, which
+	// doesn't move the snake and so isn't in the input. If the game wasn't really won,
+	// the snake is left where it is and the game stays active.
+	if (m_status == STATUS_ACTIVE && m_reader.GetRecordedStatus() == STATUS_DONE)
+	{
+		m_pBrain->ClearDirection();
+		m_status = m_pWorld->Update(*m_pBrain);
+	}
+
+	m_tickAllocations = tickAllocations.GetCounts();
+
+	m_length = m_pWorld->GetSnake()->GetLength();
+	return true;
+}
+
+bool ReplayRunner::Matches() const
+{
+	return m_status == m_reader.GetRecordedStatus() &&
+		m_length == m_reader.GetRecordedLength() &&
+		m_numTicks == m_reader.GetRecordedNumTicks();
+}
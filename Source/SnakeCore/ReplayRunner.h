@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ReplayReader.h"
+#include "World.h"
+#include "../Engine/AllocationTracker.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class ReplayBrain;
+
+// Re-simulates recorded games without a window, as fast as the rules can be run,
+// and checks that each one ends the way it was recorded
+class ReplayRunner
+{
+public:
+	ReplayRunner();
+	~ReplayRunner();
+
+	// Plays back the replay held in memory.
+	// Returns false if the data isn't a valid replay.
+	bool Run(const uint8_t* pData, size_t size);
+
+	// Returns true if the last replay ended with the recorded status, length and number of ticks
+	bool Matches() const;
+
+	// Result of re-simulating the last replay
+	SnakeStatus GetStatus() const { return m_status; }
+	size_t GetLength()      const { return m_length; }
+	uint64_t GetNumTicks()  const { return m_numTicks; }
+
+	// Allocations made while the last replay's ticks were simulated, not counting opening it
+	// or setting up the world (see AllocationTracker, all 0 in builds without tracking)
+	AllocationCounts GetTickAllocations() const { return m_tickAllocations; }
+
+	// The last replay, including the result it was recorded with
+	const ReplayReader& GetReplay() const { return m_reader; }
+
+private:
+	ReplayReader                 m_reader;
+	std::unique_ptr<World>       m_pWorld; // Reused while replays keep the same board size
+	std::unique_ptr<ReplayBrain> m_pBrain;
+	SnakeStatus                  m_status;
+	size_t                       m_length;
+	uint64_t                     m_numTicks;
+	AllocationCounts             m_tickAllocations;
+};
@@ -0,0 +1,107 @@
+#include "ReplaySeeker.h"
+#include "ReplayKeyframe.h"
+
+#include <cassert>
+
+ReplaySeeker::ReplaySeeker()
+	: m_tick(0)
+	, m_runTicksLeft(0)
+	, m_runDir(DIRECTION_NORTH)
+	, m_status(STATUS_ACTIVE)
+{
+}
+
+ReplaySeeker::~ReplaySeeker()
+{
+}
+
+bool ReplaySeeker::Open(const uint8_t* pData, size_t size)
+{
+	if (!m_reader.Open(pData, size))
+		return false;
+
+	const int width  = m_reader.GetWidth();
+	const int height = m_reader.GetHeight();
+
+	if (!m_pWorld || m_pWorld->GetWidth() != width || m_pWorld->GetHeight() != height)
+	{
+		m_pWorld = std::make_unique<World>(width, height, m_reader.GetSeed());
+	}
+
+	Restart();
+	return true;
+}
+
+bool ReplaySeeker::Seek(uint64_t tick)
+{
+	assert(m_pWorld && "No replay has been opened!");
+
+	if (!m_reader.IsValid())
+		return false;
+
+	const size_t keyframe = m_reader.FindKeyframe(tick);
+	const bool hasKeyframe = keyframe < m_reader.GetNumKeyframes();
+	const uint64_t keyframeTick = hasKeyframe ? m_reader.GetKeyframeTick(keyframe) : 0;
+
+	// Carry on from the current tick if no keyframe is closer
+	if (tick < m_tick || m_tick < keyframeTick)
+	{
+		if (hasKeyframe)
+		{
+			if (!RestoreKeyframe(keyframe))
+				return false;
+		}
+		else
+		{
+			Restart();
+		}
+	}
+
+	return Advance(tick - m_tick);
+}
+
+void ReplaySeeker::Restart()
+{
+	m_pWorld->Reset(m_reader.GetSeed());
+	m_reader.Rewind();
+
+	m_tick         = 0;
+	m_runTicksLeft = 0;
+	m_status       = STATUS_ACTIVE;
+}
+
+bool ReplaySeeker::RestoreKeyframe(size_t index)
+{
+	const uint8_t* pKeyframe;
+	size_t keyframeSize;
+	if (!m_reader.SeekToKeyframe(index, pKeyframe, keyframeSize) ||
+		!ReplayKeyframe::Read(pKeyframe, keyframeSize, *m_pWorld))
+		return false;
+
+	m_tick         = m_reader.GetKeyframeTick(index);
+	m_runTicksLeft = 0;
+	m_status       = STATUS_ACTIVE;
+	return true;
+}
+
+bool ReplaySeeker::Advance(uint64_t numTicks)
+{
+	while (numTicks > 0 && m_status == STATUS_ACTIVE)
+	{
+		if (m_runTicksLeft == 0)
+		{
+			if (!m_reader.NextRun(m_runDir, m_runTicksLeft))
+				break;
+		}
+
+		// Each run is played back in as few updates as the world can make it in
+		uint64_t numUpdates;
+		m_status = m_pWorld->UpdateStraight(m_runDir, numTicks < m_runTicksLeft ? numTicks : m_runTicksLeft, numUpdates);
+
+		m_runTicksLeft -= numUpdates;
+		m_tick         += numUpdates;
+		numTicks       -= numUpdates;
+	}
+
+	return m_reader.IsValid();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ReplayReader.h"
+#include "World.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Jumps to any tick of a recorded game.
+//
+// Seeking restores the last keyframe at or before the tick (found by binary searching the
+// replay's index) and plays back the input from there, so at most one keyframe interval of
+// ticks is simulated however long the game is. Seeking forwards from the current tick
+// carries on from there instead when that is closer. Replays without keyframes are played
+// back from the start.
+class ReplaySeeker
+{
+public:
+	ReplaySeeker();
+	~ReplaySeeker();
+
+	// Opens the replay held in memory, leaving the world at the start of the game.
+	// The data must stay valid until another replay is opened.
+	// Returns false if the data isn't a valid replay.
+	bool Open(const uint8_t* pData, size_t size);
+
+	// Puts the world into its state after the given number of ticks. If the input ends
+	// first, the world is left as the input ends (see GetTick).
+	// Returns false if the data is malformed.
+	bool Seek(uint64_t tick);
+
+	// Number of ticks played back to reach the world's current state
+	uint64_t GetTick() const { return m_tick; }
+
+	// Status returned by the last update played back
+	SnakeStatus GetStatus() const { return m_status; }
+
+	const World& GetWorld() const { return *m_pWorld; }
+	const ReplayReader& GetReplay() const { return m_reader; }
+
+private:
+	// Starts playback from the beginning of the game
+	void Restart();
+
+	// Starts playback from a keyframe. Returns false if it is malformed.
+	bool RestoreKeyframe(size_t index);
+
+	// Plays back up to numTicks ticks of input
+	bool Advance(uint64_t numTicks);
+
+	ReplayReader                 m_reader;
+	std::unique_ptr<World>       m_pWorld; // Reused while replays keep the same board size
+	uint64_t                     m_tick;
+	uint64_t                     m_runTicksLeft; // Ticks left in the run being played back
+	Direction                    m_runDir;       // Direction of the run being played back
+	SnakeStatus                  m_status;
+};
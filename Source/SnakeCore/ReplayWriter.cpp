@@ -0,0 +1,151 @@
+#include "ReplayWriter.h"
+#include "ReplayFormat.h"
+#include "ReplayKeyframe.h"
+#include "World.h"
+#include "../Engine/Util.h"
+
+#include <cassert>
+#include <ostream>
+
+ReplayWriter::ReplayWriter(std::ostream& stream, int worldWidth, int worldHeight, uint64_t seed,
+	uint64_t keyframeInterval)
+	: m_stream(stream)
+	, m_offset(0)
+	, m_keyframeInterval(keyframeInterval)
+	, m_numTicks(0)
+	, m_runLength(0)
+	, m_runDir(DIRECTION_NORTH)
+	, m_finished(false)
+{
+	assert(worldWidth > 0 && worldHeight > 0);
+
+	for (uint8_t byte : ReplayFormat::MAGIC)
+	{
+		WriteByte(byte);
+	}
+	WriteByte(ReplayFormat::VERSION);
+	WriteVarint(static_cast<uint64_t>(worldWidth));
+	WriteVarint(static_cast<uint64_t>(worldHeight));
+	WriteUint64(seed);
+	WriteVarint(keyframeInterval);
+}
+
+ReplayWriter::~ReplayWriter()
+{
+	if (!m_finished)
+	{
+		Util::DebugPrint("Replay destroyed before it was finished!\n");
+	}
+}
+
+void ReplayWriter::RecordTicks(const World& world, uint64_t numTicks)
+{
+	assert(!m_finished);
+	assert(numTicks > 0 && numTicks <= GetTicksUntilKeyframe());
+
+	const Direction dir = world.GetSnake()->GetDirection();
+
+	// A turn ends the current run
+	if (m_runLength > 0 && dir != m_runDir)
+	{
+		FlushRun();
+	}
+
+	m_runDir = dir;
+	m_runLength += numTicks;
+	m_numTicks  += numTicks;
+
+	// Once the snake has died there is nothing left to seek to
+	if (m_keyframeInterval > 0 && m_numTicks % m_keyframeInterval == 0 && !world.GetSnake()->IsDead())
+	{
+		WriteKeyframe(world);
+	}
+}
+
+uint64_t ReplayWriter::GetTicksUntilKeyframe() const
+{
+	if (m_keyframeInterval == 0)
+		return UINT64_MAX;
+
+	return m_keyframeInterval - m_numTicks % m_keyframeInterval;
+}
+
+void ReplayWriter::Finish(SnakeStatus status, size_t length)
+{
+	assert(!m_finished);
+
+	if (m_runLength > 0)
+	{
+		FlushRun();
+	}
+
+	WriteVarint(ReplayFormat::END_OF_INPUT);
+
+	const uint64_t footerOffset = m_offset;
+	WriteByte(static_cast<uint8_t>(status));
+	WriteVarint(length);
+	WriteVarint(m_numTicks);
+
+	for (const IndexEntry& entry : m_index)
+	{
+		WriteUint64(entry.tick);
+		WriteUint64(entry.offset);
+	}
+
+	WriteUint64(footerOffset);
+	WriteUint64(m_index.size());
+	WriteBytes(ReplayFormat::TRAILER_MAGIC, sizeof(ReplayFormat::TRAILER_MAGIC));
+
+	m_stream.flush();
+	m_finished = true;
+}
+
+void ReplayWriter::FlushRun()
+{
+	WriteVarint(ReplayFormat::MakeRun(m_runDir, m_runLength));
+	m_runLength = 0;
+}
+
+void ReplayWriter::WriteKeyframe(const World& world)
+{
+	// Playback after the keyframe starts on a new run
+	if (m_runLength > 0)
+	{
+		FlushRun();
+	}
+
+	m_index.push_back(IndexEntry{ m_numTicks, m_offset });
+
+	m_keyframe.clear();
+	ReplayKeyframe::Write(world, m_keyframe);
+
+	WriteVarint(ReplayFormat::KEYFRAME_MARKER);
+	WriteVarint(m_keyframe.size());
+	WriteBytes(m_keyframe.data(), m_keyframe.size());
+}
+
+void ReplayWriter::WriteVarint(uint64_t value)
+{
+	uint8_t bytes[ReplayFormat::MAX_VARINT_SIZE];
+	const size_t size = ReplayFormat::EncodeVarint(value, bytes);
+	WriteBytes(bytes, size);
+}
+
+void ReplayWriter::WriteUint64(uint64_t value)
+{
+	uint8_t bytes[8];
+	ReplayFormat::WriteUint64(value, bytes);
+	WriteBytes(bytes, sizeof(bytes));
+}
+
+void ReplayWriter::WriteByte(uint8_t value)
+{
+	m_stream.put(static_cast<char>(value));
+	m_offset++;
+}
+
+void ReplayWriter::WriteBytes(const uint8_t* pData, size_t size)
+{
+	m_stream.write(reinterpret_cast<const char*>(pData), size);
+	m_offset += size;
+}
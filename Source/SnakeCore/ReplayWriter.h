@@ -0,0 +1,70 @@
+#pragma once
+
+#include "ReplayFormat.h"
+#include "WorldTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+class World;
+
+// Records a game to a stream in the replay format (see ReplayFormat.h) as it is played.
+// Hand it to World::SetReplayWriter to have every tick recorded, then call Finish once
+// the game is over.
+class ReplayWriter
+{
+public:
+	// Writes the header of a game played on a board of the given size, started from the seed.
+	// A keyframe of the world is written every keyframeInterval ticks, unless it is 0.
+	ReplayWriter(std::ostream& stream, int worldWidth, int worldHeight, uint64_t seed,
+		uint64_t keyframeInterval = ReplayFormat::DEFAULT_KEYFRAME_INTERVAL);
+	~ReplayWriter();
+
+	// Records the tick the world has just been updated by, in which the snake moved in its
+	// current direction
+	void RecordTick(const World& world) { RecordTicks(world, 1); }
+
+	// Records numTicks ticks the world has just been updated by, all in the snake's current
+	// direction. No more than GetTicksUntilKeyframe() can be recorded at once, as a keyframe
+	// is only written of the state after the last of them.
+	void RecordTicks(const World& world, uint64_t numTicks);
+
+	// Returns how many more ticks can be recorded before the next keyframe is due
+	uint64_t GetTicksUntilKeyframe() const;
+
+	// Writes the rest of the input, the result of the game and the keyframe index, then
+	// flushes the stream. Nothing more can be recorded afterwards.
+	void Finish(SnakeStatus status, size_t length);
+
+	uint64_t GetNumTicks() const { return m_numTicks; }
+	bool IsFinished()      const { return m_finished; }
+
+private:
+	struct IndexEntry
+	{
+		uint64_t tick;
+		uint64_t offset;
+	};
+
+	// Writes the run of ticks in m_runDir out to the stream
+	void FlushRun();
+
+	void WriteKeyframe(const World& world);
+
+	void WriteVarint(uint64_t value);
+	void WriteUint64(uint64_t value);
+	void WriteByte(uint8_t value);
+	void WriteBytes(const uint8_t* pData, size_t size);
+
+	std::ostream&           m_stream;
+	std::vector<IndexEntry> m_index;
+	std::vector<uint8_t>    m_keyframe;   // Scratch space for encoding keyframes
+	uint64_t                m_offset;     // Number of bytes written so far
+	uint64_t                m_keyframeInterval;
+	uint64_t                m_numTicks;
+	uint64_t                m_runLength;  // Ticks spent moving in m_runDir since the last run was written
+	Direction               m_runDir;
+	bool                    m_finished;
+};
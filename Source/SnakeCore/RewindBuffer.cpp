@@ -0,0 +1,154 @@
+#include "RewindBuffer.h"
+#include "Snake.h"
+
+#include <cassert>
+
+RewindBuffer::RewindBuffer(size_t capacity)
+	: m_ticks(capacity)
+	, m_numApplied(0)
+{
+	assert(capacity > 0);
+}
+
+void RewindBuffer::Clear()
+{
+	m_ticks.Clear();
+	m_numApplied = 0;
+}
+
+SnakeStatus RewindBuffer::Update(World& world, SnakeBrain& brain)
+{
+	// The game is carrying on from an earlier tick, so the ticks after it no longer happen
+	while (!IsAtLatest())
+	{
+		m_ticks.PopBack();
+	}
+
+	WorldState before;
+	world.GetState(before);
+
+	const Snake* pSnake  = world.GetSnake();
+	const CellPos tail   = pSnake->GetTailPosition();
+	const bool tailFreed = !pSnake->IsGrowing();
+
+	const SnakeStatus status = world.Update(brain);
+
+	// A game is only won on the update after the last food is eaten, which doesn't move the
+	// snake, so there is nothing to record
+	if (status == STATUS_DONE)
+		return status;
+
+	if (m_ticks.Empty())
+	{
+		m_firstState = before;
+	}
+	else if (m_ticks.Size() == m_ticks.Capacity())
+	{
+		// Forget the oldest tick
+		m_firstState = m_ticks.Front().after;
+		m_ticks.PopFront();
+		m_numApplied--;
+	}
+
+	TickDelta delta;
+	world.GetState(delta.after);
+	delta.head      = pSnake->GetHeadPosition();
+	delta.tail      = tail;
+	delta.tailFreed = tailFreed;
+
+	m_ticks.PushBack(delta);
+	m_numApplied++;
+
+	return status;
+}
+
+size_t RewindBuffer::StepBack(World& world, size_t numTicks)
+{
+	size_t numStepped = 0;
+	while (numStepped < numTicks && m_numApplied > 0)
+	{
+		m_numApplied--;
+		Undo(world, m_numApplied);
+		numStepped++;
+	}
+	return numStepped;
+}
+
+size_t RewindBuffer::StepForward(World& world, size_t numTicks)
+{
+	size_t numStepped = 0;
+	while (numStepped < numTicks && !IsAtLatest())
+	{
+		Redo(world, m_numApplied);
+		m_numApplied++;
+		numStepped++;
+	}
+	return numStepped;
+}
+
+const WorldState& RewindBuffer::GetStateBefore(size_t index) const
+{
+	return index == 0 ? m_firstState : m_ticks[index - 1].after;
+}
+
+bool RewindBuffer::AteFood(size_t index) const
+{
+	const TickDelta& delta = m_ticks[index];
+	return !delta.after.dead && delta.head == GetStateBefore(index).foodPosition;
+}
+
+void RewindBuffer::Undo(World& world, size_t index)
+{
+	const TickDelta& delta = m_ticks[index];
+	Snake* pSnake = world.GetSnake();
+
+	const bool ateFood = AteFood(index);
+
+	// Take away the food that was placed after eating
+	if (ateFood && !delta.after.noFoodLeft)
+	{
+		world.FreeCell(delta.after.foodPosition.x, delta.after.foodPosition.y);
+	}
+
+	// A head that died didn't occupy its cell, and the food goes back under an eating head
+	pSnake->PopHead();
+	if (!delta.after.dead && !ateFood)
+	{
+		world.FreeCell(delta.head.x, delta.head.y);
+	}
+
+	// Done after removing the head, as the head can move into the cell the tail left
+	if (delta.tailFreed)
+	{
+		pSnake->PushTail(delta.tail);
+		world.OccupyCell(delta.tail.x, delta.tail.y);
+	}
+
+	world.SetStateExceptBody(GetStateBefore(index));
+}
+
+void RewindBuffer::Redo(World& world, size_t index)
+{
+	const TickDelta& delta = m_ticks[index];
+	Snake* pSnake = world.GetSnake();
+
+	// Same order as Snake::Move: the tail leaves its cell before the head moves in
+	if (delta.tailFreed)
+	{
+		world.FreeCell(delta.tail.x, delta.tail.y);
+		pSnake->PopTail();
+	}
+
+	pSnake->PushHead(delta.head);
+	if (!delta.after.dead)
+	{
+		world.OccupyCell(delta.head.x, delta.head.y);
+	}
+
+	if (AteFood(index) && !delta.after.noFoodLeft)
+	{
+		world.OccupyCell(delta.after.foodPosition.x, delta.after.foodPosition.y);
+	}
+
+	world.SetStateExceptBody(delta.after);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../Engine/RingBuffer.h"
+#include "World.h"
+#include "WorldTypes.h"
+
+#include <cstddef>
+
+class SnakeBrain;
+
+// Remembers the last ticks of a game, so the world can be stepped backwards and forwards
+// through them, e.g. to look back at what just happened.
+//
+// Each tick is stored as a small delta rather than a copy of the world: the cell the head
+// moved into, the tail cell that was freed (if the snake wasn't growing) and the state the
+// tick left behind that isn't in the body (generator, food, direction, grow counter). Stepping
+// one tick in either direction only touches the ends of the snake and the food, so it takes
+// the same time however large the world or long the snake is.
+//
+// Once full, the oldest tick is forgotten to make room for each new one.
+class RewindBuffer
+{
+public:
+	explicit RewindBuffer(size_t capacity);
+
+	// Forgets every recorded tick. Call whenever the world starts a new game.
+	void Clear();
+
+	// Updates the world and records the tick. Ticks that were stepped back over are forgotten,
+	// as the game now carries on differently.
+	SnakeStatus Update(World& world, SnakeBrain& brain);
+
+	// Undoes up to numTicks recorded ticks. Returns the number of ticks stepped back.
+	size_t StepBack(World& world, size_t numTicks = 1);
+
+	// Redoes up to numTicks ticks that were stepped back over. Returns the number of ticks stepped forward.
+	size_t StepForward(World& world, size_t numTicks = 1);
+
+	// Number of ticks the world has been stepped back from the latest one recorded
+	size_t GetNumTicksBack() const { return m_ticks.Size() - m_numApplied; }
+	bool IsAtLatest()        const { return m_numApplied == m_ticks.Size(); }
+
+	size_t GetNumRecorded() const { return m_ticks.Size(); }
+	size_t GetCapacity()    const { return m_ticks.Capacity(); }
+
+private:
+	struct TickDelta
+	{
+		WorldState after;     // State the tick left behind, apart from the body
+		CellPos    head;      // Cell the head moved into
+		CellPos    tail;      // Tail before the tick
+		bool       tailFreed; // The snake wasn't growing, so its tail left its cell
+	};
+
+	// Returns the state before a recorded tick, apart from the body
+	const WorldState& GetStateBefore(size_t index) const;
+
+	// Returns true if the snake ate the food on a recorded tick
+	bool AteFood(size_t index) const;
+
+	void Undo(World& world, size_t index);
+	void Redo(World& world, size_t index);
+
+	RingBuffer<TickDelta> m_ticks;      // Ordered from oldest to latest
+	WorldState            m_firstState; // State before the oldest recorded tick, apart from the body
+	size_t                m_numApplied; // Number of recorded ticks the world is currently past
+};
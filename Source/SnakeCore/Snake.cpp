@@ -0,0 +1,308 @@
+#include "Snake.h"
+#include "SnakeBrain.h"
+#include "World.h"
+#include "../Engine/Util.h"
+
+#include <cassert>
+
+using Util::DebugPrint;
+
+namespace
+{
+	// Most room the body starts with. On boards small enough for the world to store its grids
+	// flat, the body has room to cover the whole board from the start (32KB at most, counting
+	// the chain's anchors), so the snake never allocates as it grows. On larger ones it grows
+	// as the snake does, rather than being allocated for every cell of the world up front,
+	// which very large worlds couldn't hold.
+	constexpr size_t MAX_INITIAL_BODY_CAPACITY = BitGrid::MAX_FLAT_SIZE + 1;
+
+	size_t GetInitialBodyCapacity(int worldWidth, int worldHeight)
+	{
+		// One more segment than the board has cells, for the head pushed out of it as the snake dies
+		const size_t coveringLength = static_cast<size_t>(worldWidth) * worldHeight + 1;
+		return coveringLength < MAX_INITIAL_BODY_CAPACITY ? coveringLength : MAX_INITIAL_BODY_CAPACITY;
+	}
+}
+
+CellPos Snake::CalcStartPos(int worldWidth, int worldHeight)
+{
+	// Places the snake's head at the centre of the world
+	return CellPos{ static_cast<CellCoord>(worldWidth / 2), static_cast<CellCoord>(worldHeight / 2) };
+}
+
+Snake::Snake(World& world, int worldWidth, int worldHeight)
+	: m_body(GetInitialBodyCapacity(worldWidth, worldHeight))
+	, m_world(world)
+	, m_startPos(CalcStartPos(worldWidth, worldHeight))
+	, m_headSerial(0)
+{
+	DebugPrint("Snake starting pos is at: (%d, %d)\n", m_startPos.x, m_startPos.y);
+
+	Init();
+}
+
+Snake::~Snake()
+{ 
+	DebugPrint("Snake destroyed\n");
+}
+
+void Snake::Init()
+{
+	m_growCounter = 0;
+	m_dir         = INITIAL_DIRECTION;
+	m_dead        = false;
+
+	m_body.Clear();
+	PushBackSegment(m_startPos);
+
+	// Artifically grow the head of the snake to its starting length
+	for (size_t i = 1; i < INITIAL_LENGTH; i++)
+		Grow();
+
+	MarkOccupiedCells();
+}
+
+void Snake::Reset()
+{
+	Init();
+}
+
+void Snake::Restore(const CellPos* pSegments, size_t length, Direction dir, int growCounter, bool dead)
+{
+	assert(length > 0);
+
+	SetMoveState(dir, growCounter, dead);
+
+	m_body.Clear();
+	m_body.Reserve(length);
+	for (size_t i = 0; i < length; i++)
+	{
+		m_body.PushBack(pSegments[i]);
+	}
+}
+
+void Snake::Restore(CellPos head, const uint8_t* pPackedLinks, size_t length, Direction dir, int growCounter, bool dead)
+{
+	assert(length > 0);
+
+	SetMoveState(dir, growCounter, dead);
+
+	m_body.Unpack(head, pPackedLinks, length);
+}
+
+void Snake::SetMoveState(Direction dir, int growCounter, bool dead)
+{
+	m_growCounter = growCounter;
+	m_dir         = dir;
+	m_dead        = dead;
+}
+
+void Snake::PushHead(CellPos pos)
+{
+	// Unlike a head that moves, one being put back doesn't go through CheckForDeath. The cell
+	// of a head that lived was free or held the food.
+	const bool lived = m_world.InBounds(pos.x, pos.y) && (m_world.IsFree(pos.x, pos.y) || m_world.HasFoodAt(pos.x, pos.y));
+
+	PushFrontSegment(pos);
+	if (lived)
+	{
+		m_world.SetSegmentSerial(pos.x, pos.y, m_headSerial);
+	}
+}
+
+void Snake::PopHead()
+{
+	assert(m_body.Size() > 1);
+
+	m_body.PopFront();
+	m_headSerial--;
+}
+
+void Snake::PushTail(CellPos pos)
+{
+	PushBackSegment(pos);
+}
+
+void Snake::PopTail()
+{
+	assert(m_body.Size() > 1);
+
+	m_body.PopBack();
+}
+
+void Snake::Update(SnakeBrain& brain)
+{
+	// Update behaviour
+	brain.Update(this);
+}
+
+bool Snake::HandleGrowth()
+{
+	// Grow the snake if needed
+	if (m_growCounter > 0)
+	{
+		m_growCounter--;
+		return true;
+	}
+
+	return false;
+}
+
+void Snake::Simulate(Direction inputDir)
+{
+	const bool grow = HandleGrowth();
+
+	Move(inputDir, grow);
+	CheckForDeath();
+}
+
+void Snake::SimulateStraight(Direction inputDir, size_t numTicks)
+{
+	assert(!m_dead);
+
+	// Growing takes the first ticks, and the tail vacates a cell on each of the rest
+	const size_t numGrowTicks = numTicks < static_cast<size_t>(m_growCounter) ? numTicks : m_growCounter;
+	m_growCounter -= static_cast<int>(numGrowTicks);
+
+	// The new head cells were all free, so none of them is also in the body and the order the
+	// ends are moved in doesn't matter. The head cells are occupied as one run of cells.
+	const CellPos first = Step(m_body.Front(), inputDir);
+
+	m_dir = inputDir;
+	for (size_t i = 0; i < numTicks; i++)
+	{
+		StepHead(inputDir);
+		const CellPos pos = m_body.Front();
+		m_world.SetSegmentSerial(pos.x, pos.y, m_headSerial);
+	}
+
+	m_world.OccupyRun(first.x, first.y, inputDir, static_cast<int>(numTicks));
+
+	for (size_t i = numGrowTicks; i < numTicks; i++)
+	{
+		const CellPos tailPos = m_body.Back();
+		m_world.FreeCell(tailPos.x, tailPos.y);
+
+		m_body.PopBack();
+	}
+}
+
+void Snake::EatFood(int growthValue)
+{
+	m_growCounter += growthValue;
+}
+
+void Snake::Move(Direction inputDir, bool grow)
+{
+	// Rather than moving every segment to where its parent is, the body
+	// stays in place and only the ends change: the tail leaves its cell
+	// (unless the snake is growing) and a new head is pushed in front.
+	if (!grow)
+	{
+		const CellPos tailPos = m_body.Back();
+		m_world.FreeCell(tailPos.x, tailPos.y);
+
+		m_body.PopBack();
+	}
+
+	m_dir = inputDir;
+	StepHead(m_dir);
+}
+
+void Snake::Grow()
+{
+	assert(!m_body.Empty());
+
+	const size_t lastSegmentIndex = m_body.Size() - 1;
+	const CellPos lastSegmentPos = m_body.Back();
+
+	// Calculate the direction that the last segment is facing
+	Direction segmentDir;
+
+	// Last segment is the head
+	if (m_body.Size() == 1)
+	{
+		segmentDir = GetDirection();
+	}
+	else
+	{
+		// A segment faces towards the segment that comes before it (its parent)
+		segmentDir = Opposite(m_body.GetLink(lastSegmentIndex - 1));
+	}
+	// Position the new segment behind where the last segment is facing
+	PushBackSegment(Step(lastSegmentPos, Opposite(segmentDir)));
+}
+
+void Snake::PushFrontSegment(CellPos pos)
+{
+	ReserveSegment();
+	m_body.PushFront(pos);
+	m_headSerial++;
+}
+
+void Snake::StepHead(Direction dir)
+{
+	ReserveSegment();
+	m_body.PushFrontStep(dir);
+	m_headSerial++;
+}
+
+void Snake::PushBackSegment(CellPos pos)
+{
+	const uint32_t serial = m_headSerial - static_cast<uint32_t>(m_body.Size());
+	ReserveSegment();
+	m_body.PushBack(pos);
+
+	// Only the head of a dead snake being restored can be outside the world, and the cell of
+	// one inside it is recorded again when the segment under it is pushed
+	if (m_world.InBounds(pos.x, pos.y))
+	{
+		m_world.SetSegmentSerial(pos.x, pos.y, serial);
+	}
+}
+
+void Snake::ReserveSegment()
+{
+	// Doubling keeps the time spent copying the body down to a constant per segment
+	if (m_body.Size() == m_body.Capacity())
+	{
+		m_body.Reserve(m_body.Capacity() * 2);
+	}
+}
+
+void Snake::MarkOccupiedCells()
+{
+	for (const CellPos& pos : m_body)
+	{
+		m_world.OccupyCell(pos.x, pos.y);
+	}
+}
+
+void Snake::CheckForDeath()
+{
+	// The two conditions that trigger a game over:
+	// 1. Snake head touched world bounds
+	// 2. Snake head collided with body
+	
+	const int headX = m_body.Front().x;
+	const int headY = m_body.Front().y;
+
+	// Collision with world boundary
+	if (!m_world.InBounds(headX, headY))
+	{
+		m_dead = true;
+		return;
+	}
+
+	// Test self-collision. The tail has already vacated its cell (if it was going to),
+	// so the head only collides with the body if its new cell is still occupied.
+	// The food's cell is also marked as occupied, but is safe to move into.
+	if (!m_world.IsFree(headX, headY) && !m_world.HasFoodAt(headX, headY))
+	{
+		m_dead = true;
+		return;
+	}
+
+	m_world.OccupyCell(headX, headY);
+	m_world.SetSegmentSerial(headX, headY, m_headSerial);
+}
\ No newline at end of file
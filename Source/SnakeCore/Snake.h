@@ -0,0 +1,112 @@
+#pragma once
+
+#include "DirectionChain.h"
+#include "WorldTypes.h"
+
+#include <cstdint>
+
+class World;
+class SnakeBrain;
+
+class Snake
+{
+public:
+	Snake(World& world, int worldWidth, int worldHeight);
+	~Snake();
+
+	void Reset();
+
+	// Puts the snake back into a saved state. pSegments holds length positions, from head to tail.
+	// Unlike moving, this neither marks the cells the body covers as occupied nor numbers them
+	// (see World::SetState).
+	void Restore(const CellPos* pSegments, size_t length, Direction dir, int growCounter, bool dead);
+
+	// As above, with the body given by its head and the directions written by DirectionChain::Pack
+	void Restore(CellPos head, const uint8_t* pPackedLinks, size_t length, Direction dir, int growCounter, bool dead);
+
+	// Sets the state that isn't held in the body
+	void SetMoveState(Direction dir, int growCounter, bool dead);
+
+	// Adds or removes a segment at either end of the body without touching the world's
+	// occupied cells. Used to step through recorded ticks (see RewindBuffer).
+	void PushHead(CellPos pos);
+	void PopHead();
+	void PushTail(CellPos pos);
+	void PopTail();
+
+	void Update(SnakeBrain& brain);
+
+	void Simulate(Direction inputDir);
+
+	// Moves the snake numTicks ticks in a straight line in one go, as numTicks calls to Simulate
+	// would. Every cell the head moves into must be free and within the world (see
+	// World::UpdateStraight), so none of the ticks can kill the snake or eat food.
+	void SimulateStraight(Direction inputDir, size_t numTicks);
+	void EatFood(int growValue);
+
+	CellPos GetHeadPosition()           const { return m_body.Front(); }
+	CellPos GetTailPosition()           const { return m_body.Back(); }
+	Direction GetDirection()            const { return m_dir; }
+	const DirectionChain& GetBody()     const { return m_body; }
+	size_t GetLength()                  const { return m_body.Size(); }
+
+	// Segments are numbered as they are added, counting up from the tail to the head, so the
+	// segment numbered s is s - GetTailSerial() moves (not counting growth) from leaving its
+	// cell. The numbers wrap around, so only differences between them are meaningful.
+	uint32_t GetHeadSerial() const { return m_headSerial; }
+	uint32_t GetTailSerial() const { return m_headSerial - static_cast<uint32_t>(m_body.Size()) + 1; }
+
+	bool IsDead()        const { return m_dead; }
+	bool IsGrowing()     const { return m_growCounter > 0; }
+	int GetGrowCounter() const { return m_growCounter; }
+
+	static constexpr size_t HEAD_INDEX = 0;
+	static constexpr size_t NECK_INDEX = 1;
+	static constexpr size_t INITIAL_LENGTH = 3;
+	static constexpr Direction INITIAL_DIRECTION = DIRECTION_EAST;
+
+	// Returns the cell the snake's head starts in
+	static CellPos CalcStartPos(int worldWidth, int worldHeight);
+
+private:
+	// Sets snake to its starting state
+	void Init();
+
+	// Advances the head one cell. Unless the snake is growing, the tail vacates its cell.
+	void Move(Direction inputDir, bool grow);
+
+	// Returns true if the snake grows during this update
+	bool HandleGrowth();
+
+	// Appends a segment behind the tail
+	void Grow();
+
+	// Adds a segment to the front or back of the body and numbers it (see GetHeadSerial).
+	// Segments added to the back have their number recorded in the world straight away, but a
+	// new head's is only recorded once it is known to have lived: a head that died is either
+	// outside the world or in a cell that still holds another segment.
+	void PushFrontSegment(CellPos pos);
+	void StepHead(Direction dir);
+	void PushBackSegment(CellPos pos);
+
+	// Makes room in the body for one more segment
+	void ReserveSegment();
+
+	// Marks any cells the snake is over as being occupied
+	void MarkOccupiedCells();
+
+	// Tests conditions for snake death. If a condition was triggered, m_dead is set to true.
+	// Otherwise the cell the head moved into is marked as occupied.
+	void CheckForDeath();
+
+	DirectionChain       m_body; // Ordered from head to tail
+	const CellPos        m_startPos;
+	World&               m_world;
+	Direction            m_dir;
+	uint32_t             m_headSerial; // Number of the head segment
+
+	// Tracks the remaining number of times the snake has to grow
+	// since growing to a particular length spans multiple updates
+	int                  m_growCounter; 
+	bool                 m_dead;
+};
\ No newline at end of file
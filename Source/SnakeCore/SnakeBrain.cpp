@@ -0,0 +1,7 @@
+#include "SnakeBrain.h"
+#include "../Engine/Util.h"
+
+SnakeBrain::~SnakeBrain()
+{
+	Util::DebugPrint("SnakeBrain destroyed!\n");
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+class Snake;
+
+// Determines snake behaviour
+class SnakeBrain
+{
+public:
+	virtual ~SnakeBrain();
+
+	// Called once per world update to decide how the snake moves
+	virtual void Update(Snake* pSnake) = 0;
+};
@@ -0,0 +1,595 @@
+#include "World.h"
+#include "ReplayWriter.h"
+#include "WorldSnapshot.h"
+#include "../Engine/Util.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+World::World(int width, int height, uint64_t seed)
+	: m_pReplayWriter(nullptr)
+	, m_occupiedCells(width, height)
+	, m_segmentSerials(width, height)
+	, m_foodCells(width, height)
+	, m_foodCellIndex(-1)
+	, m_maxFood(1)
+	, m_nextMaxFood(1)
+	, m_numFood(0)
+	, m_rng(seed)
+	, m_seed(seed)
+	, m_worldWidth(width)
+	, m_worldHeight(height)
+	, m_noFoodLeft(false)
+{
+	assert(width > 0 && width <= MAX_SIZE && height > 0 && height <= MAX_SIZE);
+
+	m_pSnake = std::make_unique<Snake>(*this, m_worldWidth, m_worldHeight);
+	
+	GenerateFood();
+}
+
+World::~World()
+{ 
+	Util::DebugPrint("World destroyed\n");
+}
+
+void World::Reset(uint64_t seed)
+{
+	m_rng.Seed(seed);
+	m_seed = seed;
+
+	m_maxFood = m_nextMaxFood;
+
+	ClearAll();
+	m_pSnake->Reset();
+	GenerateFood();
+}
+
+SnakeStatus World::Update(SnakeBrain& brain)
+{
+	assert(m_foodCellIndex >= 0);
+
+	// Check if the player has eaten all food
+	if (m_noFoodLeft)
+	{
+		return STATUS_DONE;
+	}
+
+	// The snake keeps its occupied cells up to date as it moves
+	m_pSnake->Update(brain);
+
+	return FinishUpdate();
+}
+
+SnakeStatus World::UpdateStraight(Direction dir, uint64_t numTicks, uint64_t& outNumTicks)
+{
+	assert(m_foodCellIndex >= 0);
+
+	outNumTicks = 0;
+	SnakeStatus status = STATUS_ACTIVE;
+
+	while (outNumTicks < numTicks && status == STATUS_ACTIVE)
+	{
+		// Check if the player has eaten all food
+		if (m_noFoodLeft)
+		{
+			outNumTicks++;
+			return STATUS_DONE;
+		}
+
+		// Until the head reaches something, an update only moves the snake, so those updates
+		// are all made at once. A keyframe can only be written at the end of a tick.
+		uint64_t maxClearTicks = numTicks - outNumTicks;
+		if (m_pReplayWriter)
+		{
+			const uint64_t ticksUntilKeyframe = m_pReplayWriter->GetTicksUntilKeyframe();
+			maxClearTicks = ticksUntilKeyframe < maxClearTicks ? ticksUntilKeyframe : maxClearTicks;
+		}
+
+		const uint64_t numClearTicks = CountClearTicks(dir, maxClearTicks);
+		if (numClearTicks > 0)
+		{
+			m_pSnake->SimulateStraight(dir, static_cast<size_t>(numClearTicks));
+			outNumTicks += numClearTicks;
+
+			if (m_pReplayWriter)
+			{
+				m_pReplayWriter->RecordTicks(*this, numClearTicks);
+			}
+			continue;
+		}
+
+		// The head reaches the wall, food or body (which may have moved on by then) this update
+		m_pSnake->Simulate(dir);
+		status = FinishUpdate();
+		outNumTicks++;
+	}
+
+	return status;
+}
+
+SnakeStatus World::FinishUpdate()
+{
+	// Nothing from the scratch memory of earlier ticks is still in use
+	m_tickScratch.Reset();
+
+	// See if snake died this update
+	const SnakeStatus status = m_pSnake->IsDead() ? STATUS_DEAD : STATUS_ACTIVE;
+
+	if (status == STATUS_ACTIVE)
+	{
+		const int headX = m_pSnake->GetHeadPosition().x;
+		const int headY = m_pSnake->GetHeadPosition().y;
+
+		// Check if food was eaten
+		if (HasFoodAt(headX, headY))
+		{
+			m_foodCells.Clear(headX, headY);
+			m_numFood--;
+
+			m_pSnake->EatFood(FOOD_VALUE);
+			Util::DebugPrint("Snake consumed food at (%d, %d)\n", headX, headY);
+
+			GenerateFood();
+		}
+	}
+
+	// Recorded once the tick is complete, so the writer sees the new food
+	if (m_pReplayWriter)
+	{
+		m_pReplayWriter->RecordTick(*this);
+	}
+
+	return status;
+}
+
+void World::GetState(WorldState& outState) const
+{
+	assert(m_maxFood == 1 && "Saved states only hold one piece of food!");
+
+	outState.rng          = m_rng;
+	outState.foodPosition = GetFoodPosition();
+	outState.direction    = m_pSnake->GetDirection();
+	outState.growCounter  = m_pSnake->GetGrowCounter();
+	outState.noFoodLeft   = m_noFoodLeft;
+	outState.dead         = m_pSnake->IsDead();
+}
+
+void World::SetState(const WorldState& state, const CellPos* pSegments, size_t length)
+{
+	ClearAll();
+	m_pSnake->Restore(pSegments, length, state.direction, state.growCounter, state.dead);
+	SetStateAfterBody(state);
+}
+
+void World::SetStateAfterBody(const WorldState& state)
+{
+	// The body is marked and numbered here rather than by the snake, in one pass, as restoring
+	// a long snake is dominated by this loop. Segments are numbered as Snake::PushBackSegment
+	// would have, counting down from the head. The head of a dead snake is skipped: it is
+	// either outside the world or in a cell another segment already covers.
+	uint32_t serial = m_pSnake->GetHeadSerial();
+	DirectionChain::ConstIterator it = m_pSnake->GetBody().begin();
+	if (state.dead)
+	{
+		++it;
+		serial--;
+	}
+	for (; it != m_pSnake->GetBody().end(); ++it, serial--)
+	{
+		OccupyCell(it->x, it->y);
+		SetSegmentSerial(it->x, it->y, serial);
+	}
+
+	SetStateExceptBody(state);
+
+	// Once all food is gone, the last food eaten is under the snake's head
+	if (!m_noFoodLeft)
+	{
+		OccupyCell(state.foodPosition.x, state.foodPosition.y);
+	}
+}
+
+void World::SetStateExceptBody(const WorldState& state)
+{
+	assert(InBounds(state.foodPosition.x, state.foodPosition.y));
+
+	m_pSnake->SetMoveState(state.direction, state.growCounter, state.dead);
+
+	m_rng           = state.rng;
+	m_noFoodLeft    = state.noFoodLeft;
+	m_foodCellIndex = ToCellIndex(state.foodPosition.x, state.foodPosition.y);
+
+	// Once all food is gone, the food position is where the last piece was eaten
+	m_foodCells.ClearAll();
+	m_numFood = m_noFoodLeft ? 0 : 1;
+	if (!m_noFoodLeft)
+	{
+		m_foodCells.Set(state.foodPosition.x, state.foodPosition.y);
+	}
+}
+
+size_t World::GetSnapshotSize() const
+{
+	return WorldSnapshot::GetSize(m_pSnake->GetLength());
+}
+
+size_t World::GetMaxSnapshotSize() const
+{
+	return WorldSnapshot::GetSize(static_cast<size_t>(m_worldWidth) * m_worldHeight);
+}
+
+WorldSnapshot* World::Save(void* pStorage) const
+{
+	assert(pStorage && reinterpret_cast<uintptr_t>(pStorage) % alignof(WorldSnapshot) == 0);
+
+	WorldSnapshot* pSnapshot = static_cast<WorldSnapshot*>(pStorage);
+	GetState(pSnapshot->state);
+
+	const DirectionChain& body = m_pSnake->GetBody();
+	pSnapshot->head   = body.Front();
+	pSnapshot->length = static_cast<uint32_t>(body.Size());
+	body.Pack(pSnapshot->GetLinks());
+
+	return pSnapshot;
+}
+
+void World::Restore(const WorldSnapshot& snapshot)
+{
+	const WorldState& state = snapshot.state;
+
+	ClearAll();
+	m_pSnake->Restore(snapshot.head, snapshot.GetLinks(), snapshot.length, state.direction, state.growCounter, state.dead);
+	SetStateAfterBody(state);
+}
+
+void World::OccupyCell(int x, int y)
+{
+	assert(InBounds(x, y));
+
+	if (m_occupiedCells.Set(x, y) && HasFoodWeights())
+	{
+		const int64_t cellIndex = ToCellIndex(x, y);
+		m_freeCellWeights.Add(cellIndex, -static_cast<int64_t>(m_foodWeights[cellIndex]));
+	}
+}
+
+void World::FreeCell(int x, int y)
+{
+	assert(InBounds(x, y));
+
+	if (m_occupiedCells.Clear(x, y) && HasFoodWeights())
+	{
+		const int64_t cellIndex = ToCellIndex(x, y);
+		m_freeCellWeights.Add(cellIndex, m_foodWeights[cellIndex]);
+	}
+}
+
+void World::OccupyRun(int x, int y, Direction dir, int length)
+{
+	assert(length > 0);
+	assert(InBounds(x, y));
+	assert(InBounds(x + DirectionTables::OFFSET_X[dir] * (length - 1), y + DirectionTables::OFFSET_Y[dir] * (length - 1)));
+
+	// Each cell's weight has to be taken out of the tree, so weighted worlds go a cell at a time
+	if (HasFoodWeights())
+	{
+		for (int i = 0; i < length; i++)
+		{
+			OccupyCell(x + DirectionTables::OFFSET_X[dir] * i, y + DirectionTables::OFFSET_Y[dir] * i);
+		}
+		return;
+	}
+
+	m_occupiedCells.SetRun(x, y, DirectionTables::OFFSET_X[dir], DirectionTables::OFFSET_Y[dir], length);
+}
+
+Cell World::GetCell(int x, int y) const
+{
+	assert(InBounds(x, y));
+
+	Cell cell;
+	cell.position = CellPos{ static_cast<CellCoord>(x), static_cast<CellCoord>(y) };
+	cell.free     = !m_occupiedCells.Get(x, y);
+	return cell;
+}
+
+bool World::InBounds(int x, int y) const
+{
+	return (x >= 0 && x < m_worldWidth) &&
+		(y >= 0 && y < m_worldHeight);
+}
+
+bool World::IsFree(int x, int y) const
+{
+	assert(InBounds(x, y));
+
+	return !m_occupiedCells.Get(x, y);
+}
+
+CellPos World::GetFoodPosition() const
+{
+	assert(m_foodCellIndex >= 0);
+
+	return CellPos{
+		static_cast<CellCoord>(m_foodCellIndex % m_worldWidth),
+		static_cast<CellCoord>(m_foodCellIndex / m_worldWidth)
+	};
+}
+
+bool World::HasFoodAt(int x, int y) const
+{
+	assert(InBounds(x, y));
+
+	// One piece of food is found by its cell index, without reading the grid
+	if (m_maxFood == 1)
+	{
+		return m_numFood != 0 && ToCellIndex(x, y) == m_foodCellIndex;
+	}
+	return m_foodCells.Get(x, y);
+}
+
+void World::SetNumFood(int numFood)
+{
+	assert(numFood >= 1);
+
+	m_nextMaxFood = numFood;
+
+	// Room for a whole batch up front (the hash set, ranks and cells, see GenerateFood), so
+	// placing food never allocates
+	m_tickScratch.Reserve((GetRankSetSize(numFood) + 2 * static_cast<size_t>(numFood)) * sizeof(int64_t));
+}
+
+uint64_t World::CountClearTicks(Direction dir, uint64_t maxTicks) const
+{
+	// The food's cell is marked as occupied too, so this stops at whichever comes first
+	const CellPos next = Step(m_pSnake->GetHeadPosition(), dir);
+	const int maxLength = maxTicks < static_cast<uint64_t>(INT32_MAX) ? static_cast<int>(maxTicks) : INT32_MAX;
+
+	return static_cast<uint64_t>(m_occupiedCells.CountClearRun(next.x, next.y,
+		DirectionTables::OFFSET_X[dir], DirectionTables::OFFSET_Y[dir], maxLength));
+}
+
+int64_t World::CountFreeCells(int x, int y, int width, int height) const
+{
+	return m_occupiedCells.CountClearIn(x, y, width, height);
+}
+
+bool World::FindNearestFreeCell(int x, int y, CellPos& outPos) const
+{
+	int cellX = 0, cellY = 0;
+	if (!m_occupiedCells.FindNearestClear(x, y, cellX, cellY))
+		return false;
+
+	outPos = CellPos{ static_cast<CellCoord>(cellX), static_cast<CellCoord>(cellY) };
+	return true;
+}
+
+bool World::SampleFreeCell(int x, int y, int width, int height, Pcg32& rng, CellPos& outPos) const
+{
+	const int64_t numFree = m_occupiedCells.CountClearIn(x, y, width, height);
+	if (numFree == 0)
+		return false;
+
+	int cellX = 0, cellY = 0;
+	const int64_t n = static_cast<int64_t>(rng.NextBounded64(static_cast<uint64_t>(numFree)));
+	const bool found = m_occupiedCells.FindNthClearIn(x, y, width, height, n, cellX, cellY);
+	assert(found);
+	(void)found;
+
+	outPos = CellPos{ static_cast<CellCoord>(cellX), static_cast<CellCoord>(cellY) };
+	return true;
+}
+
+void World::SetFoodWeights(const uint32_t* pWeights)
+{
+	if (!pWeights)
+	{
+		m_foodWeights.clear();
+		m_freeCellWeights = FenwickTree();
+		return;
+	}
+
+	const size_t numCells = static_cast<size_t>(m_worldWidth) * m_worldHeight;
+	m_foodWeights.assign(pWeights, pWeights + numCells);
+
+	// Occupied cells count as 0 until they are freed
+	std::vector<uint32_t> freeCellWeights(m_foodWeights);
+	for (int y = 0; y < m_worldHeight; y++)
+	{
+		for (int x = 0; x < m_worldWidth; x++)
+		{
+			if (m_occupiedCells.Get(x, y))
+			{
+				freeCellWeights[ToCellIndex(x, y)] = 0;
+			}
+		}
+	}
+
+	m_freeCellWeights = FenwickTree(numCells);
+	m_freeCellWeights.Build(freeCellWeights.data());
+}
+
+void World::SetFoodWeight(int x, int y, uint32_t weight)
+{
+	assert(InBounds(x, y));
+	assert(HasFoodWeights() && "Food weights must be set with SetFoodWeights first!");
+
+	const int64_t cellIndex = ToCellIndex(x, y);
+	if (!m_occupiedCells.Get(x, y))
+	{
+		m_freeCellWeights.Add(cellIndex, static_cast<int64_t>(weight) - m_foodWeights[cellIndex]);
+	}
+	m_foodWeights[cellIndex] = weight;
+}
+
+int World::GetTicksUntilFree(int x, int y) const
+{
+	assert(InBounds(x, y));
+
+	if (!m_occupiedCells.Get(x, y) || HasFoodAt(x, y))
+	{
+		return 0;
+	}
+
+	// The tail leaves its cell in the first update in which the snake doesn't grow, and each
+	// segment in front of it an update later than the one behind it
+	const uint32_t numSegmentsBehind = m_segmentSerials.Get(x, y) - m_pSnake->GetTailSerial();
+	return m_pSnake->GetGrowCounter() + static_cast<int>(numSegmentsBehind) + 1;
+}
+
+void World::GenerateFood()
+{
+	if (m_maxFood > 1)
+	{
+		// Weighted food is drawn a piece at a time, as each piece placed takes its cell's weight
+		// out of the tree
+		while (HasFoodWeights() && m_numFood < m_maxFood && m_freeCellWeights.GetTotal() > 0)
+		{
+			PlaceFood(static_cast<int64_t>(m_freeCellWeights.Find(m_rng.NextBounded64(m_freeCellWeights.GetTotal()))));
+		}
+
+		// Every other piece of food needed is drawn at once: distinct ranks among the free cells
+		// are drawn with Floyd's sampling, one number from the generator each, then sorted so one
+		// walk over the occupancy counts finds all of the cells
+		const int64_t numFreeCells = m_occupiedCells.CountClear();
+		const int numToPlace = static_cast<int>(std::min<int64_t>(m_maxFood - m_numFood, numFreeCells));
+
+		// The ranks drawn so far are kept in an open addressed hash set, empty slots holding -1
+		const size_t numSlots = GetRankSetSize(numToPlace);
+		int64_t* pRankSet = m_tickScratch.Allocate<int64_t>(numSlots);
+		std::fill(pRankSet, pRankSet + numSlots, -1);
+
+		int64_t* pRanks = m_tickScratch.Allocate<int64_t>(numToPlace);
+		int numRanks = 0;
+		auto addRank = [pRankSet, numSlots, pRanks, &numRanks](int64_t rank)
+		{
+			size_t slot = static_cast<size_t>((static_cast<uint64_t>(rank) * 0x9E3779B97F4A7C15ull) >> 32) & (numSlots - 1);
+			for (; pRankSet[slot] >= 0; slot = (slot + 1) & (numSlots - 1))
+			{
+				if (pRankSet[slot] == rank) return false;
+			}
+			pRankSet[slot] = rank;
+			pRanks[numRanks++] = rank;
+			return true;
+		};
+
+		// A rank that was drawn already is swapped for the top of the range, which no earlier
+		// draw could have reached
+		for (int64_t top = numFreeCells - numToPlace; top < numFreeCells; top++)
+		{
+			if (!addRank(static_cast<int64_t>(m_rng.NextBounded64(static_cast<uint64_t>(top + 1)))))
+			{
+				addRank(top);
+			}
+		}
+		std::sort(pRanks, pRanks + numRanks);
+
+		// The cells are only taken once they have all been found, as taking them changes the counts
+		int64_t* pNewFoodCells = m_tickScratch.Allocate<int64_t>(numToPlace);
+		int numFound = 0;
+		m_occupiedCells.FindNthClears(pRanks, numToPlace, [this, pNewFoodCells, &numFound](int x, int y)
+		{
+			pNewFoodCells[numFound++] = ToCellIndex(x, y);
+		});
+
+		for (int i = 0; i < numFound; i++)
+		{
+			PlaceFood(pNewFoodCells[i]);
+		}
+
+		// No more food can be generated, and all of it has been eaten
+		m_noFoodLeft = m_numFood == 0;
+		return;
+	}
+
+	// Every cell the snake isn't on is free, as the last food (if any) is under its head
+	const int64_t numFreeCells = m_occupiedCells.Size() - static_cast<int64_t>(m_pSnake->GetLength());
+
+	// If this fails, there's a good chance we forgot to mark the snake's 
+	// occupied cells or it is out-of-date.
+	assert(numFreeCells == m_occupiedCells.CountClear());
+
+	// No more food can be generated
+	m_noFoodLeft = numFreeCells == 0;
+	if (m_noFoodLeft) return;
+
+	// Select a random free cell, counting free cells in row-major order. Where the food ends
+	// up then only depends on which cells are occupied, not on the order they were freed in,
+	// so a game can be carried on from a saved state (see SetState). With weights, the tree
+	// of free cells' weights is searched for a random point along their running total.
+	const FenwickTree::Sum totalWeight = HasFoodWeights() ? m_freeCellWeights.GetTotal() : 0;
+	const int64_t cellIndex = totalWeight > 0
+		? static_cast<int64_t>(m_freeCellWeights.Find(m_rng.NextBounded64(totalWeight)))
+		: FindNthFreeCell(static_cast<int64_t>(m_rng.NextBounded64(static_cast<uint64_t>(numFreeCells))));
+
+	PlaceFood(cellIndex);
+}
+
+void World::PlaceFood(int64_t cellIndex)
+{
+	const int x = static_cast<int>(cellIndex % m_worldWidth);
+	const int y = static_cast<int>(cellIndex / m_worldWidth);
+	assert(IsFree(x, y));
+
+	m_foodCellIndex = cellIndex;
+	m_foodCells.Set(x, y);
+	m_numFood++;
+	OccupyCell(x, y);
+}
+
+int64_t World::FindNthFreeCell(int64_t n) const
+{
+	const DirectionChain& body = m_pSnake->GetBody();
+
+	// Scanning the board reads at least a word per row, so while the snake is shorter than
+	// that, sorting its cells is quicker. In particular, starting a new game then takes the
+	// same time on any size of board.
+	if (body.Size() <= MAX_SORTED_SNAKE_LENGTH && static_cast<int>(body.Size()) < m_worldHeight)
+	{
+		int64_t occupiedCells[MAX_SORTED_SNAKE_LENGTH];
+		size_t numOccupied = 0;
+		for (const CellPos& pos : body)
+		{
+			occupiedCells[numOccupied++] = ToCellIndex(pos.x, pos.y);
+		}
+		return FindNthFreeCell(n, occupiedCells, numOccupied);
+	}
+
+	int x = 0, y = 0;
+	const bool found = m_occupiedCells.FindNthClear(n, x, y);
+	assert(found);
+	(void)found;
+
+	return ToCellIndex(x, y);
+}
+
+int64_t World::FindNthFreeCell(int64_t n, int64_t* pOccupiedCells, size_t numOccupied)
+{
+	assert(n >= 0);
+
+	std::sort(pOccupiedCells, pOccupiedCells + numOccupied);
+
+	// Each occupied cell at or before the candidate pushes it on by one
+	int64_t cell = n;
+	for (size_t i = 0; i < numOccupied && pOccupiedCells[i] <= cell; i++)
+	{
+		cell++;
+	}
+	return cell;
+}
+
+void World::ClearAll()
+{
+	m_occupiedCells.ClearAll();
+	m_foodCells.ClearAll();
+	m_numFood = 0;
+
+	// Every cell is free again. Unlike the occupied cells, this takes time in proportion to
+	// the size of the board.
+	if (HasFoodWeights())
+	{
+		m_freeCellWeights.Build(m_foodWeights.data());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "../Engine/BitGridPyramid.h"
+#include "../Engine/ChunkedArray2D.h"
+#include "../Engine/FenwickTree.h"
+#include "../Engine/Math/Pcg32.h"
+#include "../Engine/ScratchArena.h"
+#include "Snake.h"
+#include "WorldTypes.h"
+
+#include <memory>
+#include <vector>
+
+struct Cell
+{
+	CellPos position;
+	bool free{}; // Not occupied by the snake or food
+};
+
+// The parts of a world's state that aren't held in the snake's body. Together with the
+// positions of the body's segments, this is everything needed to carry on a game exactly
+// where it was left, since which cells are occupied follows from the body and the food.
+struct WorldState
+{
+	Pcg32     rng;
+	CellPos   foodPosition;
+	Direction direction;
+	int32_t   growCounter;
+	bool      noFoodLeft;
+	bool      dead;
+};
+
+struct WorldSnapshot;
+class SnakeBrain;
+class ReplayWriter;
+
+// Holds the state of a game and applies its rules. Has no dependency on SDL,
+// so worlds can be simulated without a window or renderer.
+// All randomness comes from the world's own generator, so a game is fully
+// determined by its seed and the directions the snake is given.
+//
+// The cells are kept in chunks that are only allocated once the snake or food reaches them,
+// so a very large world only takes memory for the area that has been played on (apart from
+// food weights, which are kept for every cell).
+class World
+{
+public:
+	World(int width, int height, uint64_t seed);
+	~World();
+
+	// Starts a new game, with food placed by a generator started from the seed
+	void Reset(uint64_t seed);
+	SnakeStatus Update(SnakeBrain& brain);
+
+	// Moves the snake in a straight line for up to numTicks updates, stopping once the game is
+	// over. Plays out exactly like calling Update numTicks times with a brain that moves the
+	// snake in dir, but the updates before the head reaches the wall, the food or a cell of the
+	// body are made in one go. outNumTicks is set to the number of updates made.
+	SnakeStatus UpdateStraight(Direction dir, uint64_t numTicks, uint64_t& outNumTicks);
+
+	// Saves the state of the current game, apart from the snake's body.
+	// States hold one piece of food, so the world must have one (see SetNumFood).
+	void GetState(WorldState& outState) const;
+
+	// Carries on a game of the same board size from a saved state.
+	// pSegments holds the positions of the snake's length segments, from head to tail.
+	void SetState(const WorldState& state, const CellPos* pSegments, size_t length);
+
+	// Sets the parts of the state that aren't held in the snake's body. The body and the
+	// occupied cells are left as they are, so they must already match the state.
+	void SetStateExceptBody(const WorldState& state);
+
+	// Returns the number of bytes Save needs for the current game
+	size_t GetSnapshotSize() const;
+
+	// Returns the number of bytes Save can need on this board, whatever the snake's length
+	size_t GetMaxSnapshotSize() const;
+
+	// Saves the current game to pStorage, which must hold GetSnapshotSize() bytes and be
+	// aligned for a WorldSnapshot. Returns the snapshot, which starts at pStorage.
+	WorldSnapshot* Save(void* pStorage) const;
+
+	// Carries on a game saved from a world of the same size
+	void Restore(const WorldSnapshot& snapshot);
+
+	// Records the direction the snake moves in each update to the writer, until set to null.
+	// The brain is expected to move the snake on every update.
+	void SetReplayWriter(ReplayWriter* pWriter) { m_pReplayWriter = pWriter; }
+
+	void OccupyCell(int x, int y);
+
+	// Occupies length cells starting at (x, y) and going in the given direction
+	void OccupyRun(int x, int y, Direction dir, int length);
+	void FreeCell(int x, int y);
+	Cell GetCell(int x, int y) const;
+
+	// Returns true if the position is within the world limits
+	bool InBounds(int x, int y) const;
+
+	// Returns true if the cell located at position (x, y) is free
+	bool IsFree(int x, int y) const;
+
+	// Returns true if the cell located at position (x, y) is holding the food
+	bool HasFoodAt(int x, int y) const;
+
+	// Returns the number of free cells in the rectangle of cells from (x, y) of the given size.
+	// Parts of the rectangle outside the world are ignored. Whole 64x64 blocks of cells are
+	// counted without looking at their cells, so this is quick for large rectangles.
+	int64_t CountFreeCells(int x, int y, int width, int height) const;
+
+	// Finds the free cell nearest to (x, y), counting the steps the snake would take to get there
+	// ignoring obstacles. Returns false if no cell is free.
+	bool FindNearestFreeCell(int x, int y, CellPos& outPos) const;
+
+	// Picks one of the free cells in the rectangle of cells from (x, y) of the given size, each
+	// as likely as the others. The generator is passed in rather than the world's own, so this
+	// doesn't change how the game plays out. Returns false if no cell in the rectangle is free.
+	bool SampleFreeCell(int x, int y, int width, int height, Pcg32& rng, CellPos& outPos) const;
+
+	// Makes food more likely to be placed in some cells than others. pWeights holds a weight for
+	// each cell in row-major order, and food is placed in a free cell with probability in
+	// proportion to its weight; a cell with weight 0 never gets food unless every free cell has
+	// weight 0, in which case any free cell is as likely as the others. Null goes back to placing
+	// food in any free cell with the same probability. Takes effect from the next food placed.
+	// Replays only record the seed, so a game played with weights can only be played back by a
+	// world given the same weights.
+	void SetFoodWeights(const uint32_t* pWeights);
+
+	// Changes the weight of one cell (see SetFoodWeights), which must already have been given weights
+	void SetFoodWeight(int x, int y, uint32_t weight);
+
+	// Returns the number of updates from now after which the snake's head can move into the cell
+	// at (x, y), assuming no more food is eaten before then: 0 for a free cell or the food, or
+	// the update in which the tail leaves the cell for a cell of the body. Eating food only ever
+	// makes the wait longer. Takes the same time wherever the cell is in the body.
+	int GetTicksUntilFree(int x, int y) const;
+
+	// Returns true if the head could move into the cell at (x, y) in the numTicks-th update from now,
+	// as far as the body is concerned (see GetTicksUntilFree)
+	bool IsFreeIn(int x, int y, int numTicks) const { return GetTicksUntilFree(x, y) <= numTicks; }
+
+	// Records the number of the segment over a cell (see Snake::GetHeadSerial)
+	void SetSegmentSerial(int x, int y, uint32_t serial) { m_segmentSerials.Get(x, y) = serial; }
+
+	// Returns the position of the cell holding the food. With several pieces of food, this is the
+	// one placed last.
+	CellPos GetFoodPosition() const;
+
+	// Sets how many pieces of food are on the board at once, from the next Reset. Once there is
+	// more than one, eaten food is replaced by drawing every piece needed at once, and the game
+	// is only won once every piece has been eaten and no free cell is left for more.
+	// Saved states, rewinding and replays only hold one piece of food, so need worlds with one.
+	void SetNumFood(int numFood);
+
+	// Returns the number of pieces of food on the board
+	int GetNumFood() const { return m_numFood; }
+
+	// Calls fn(pos) with the position of each cell holding food
+	template <class Fn>
+	void ForEachFood(Fn fn) const;
+
+	Snake* GetSnake() { return m_pSnake.get(); }
+	const Snake* GetSnake() const { return m_pSnake.get(); }
+	int GetWidth() const { return m_worldWidth; }
+	int GetHeight() const { return m_worldHeight; }
+	uint64_t GetSeed() const { return m_seed; }
+
+	// How much the snake grows by for each food it eats
+	static constexpr int FOOD_VALUE = 5;
+
+	// Largest width or height a world can have
+	static constexpr int MAX_SIZE = 65536;
+
+	// Food for snakes up to this long is placed by walking their sorted cells (see FindNthFreeCell)
+	static constexpr size_t MAX_SORTED_SNAKE_LENGTH = 32;
+
+	// Returns the nth (starting from 0, in row-major order) free cell of a board on which only
+	// the given cells are occupied. pOccupiedCells holds numOccupied distinct cell indices, and
+	// is sorted in place. Takes time depending on numOccupied, rather than the size of the board.
+	static int64_t FindNthFreeCell(int64_t n, int64_t* pOccupiedCells, size_t numOccupied);
+private:
+	// Works out the result of an update in which the snake has just moved, eating any food
+	SnakeStatus FinishUpdate();
+
+	// Returns how many updates the snake can move in the given direction before its head
+	// reaches the wall, the food or a cell of the body, up to maxTicks
+	uint64_t CountClearTicks(Direction dir, uint64_t maxTicks) const;
+
+	// Marks the restored body and the state's food as occupied, and sets the rest of the state
+	void SetStateAfterBody(const WorldState& state);
+
+	// Places food until there is as much as the world holds, or no cell is free
+	void GenerateFood();
+
+	// Places a piece of food in a free cell
+	void PlaceFood(int64_t cellIndex);
+
+	// Returns the number of slots in the hash set of ranks drawn when placing numFood pieces of
+	// food at once: a power of 2, at least twice as many, so lookups stay short
+	static size_t GetRankSetSize(int numFood)
+	{
+		size_t numSlots = 2;
+		while (numSlots < 2 * static_cast<size_t>(numFood)) numSlots *= 2;
+		return numSlots;
+	}
+
+	// Returns the nth (starting from 0, in row-major order) free cell
+	int64_t FindNthFreeCell(int64_t n) const;
+
+	// Clears all cells in the world to empty
+	void ClearAll();
+
+	bool HasFoodWeights() const { return !m_foodWeights.empty(); }
+
+	// Converts a position in the world to a row-major cell index
+	int64_t ToCellIndex(int x, int y) const { return static_cast<int64_t>(y) * m_worldWidth + x; }
+
+	std::unique_ptr<Snake>  m_pSnake;
+	ReplayWriter*           m_pReplayWriter;
+	BitGridPyramid          m_occupiedCells; // A set bit marks an occupied cell
+	ChunkedArray2D<uint32_t> m_segmentSerials; // Number of the segment over each cell of the body
+	std::vector<uint32_t>   m_foodWeights; // Weight of each cell for placing food, or empty if food is placed uniformly
+	FenwickTree             m_freeCellWeights; // Weights of the cells, counting occupied cells as 0
+	BitGrid                 m_foodCells; // A set bit marks a cell holding food
+	ScratchArena            m_tickScratch; // Scratch memory for the current tick, e.g. for placing several pieces of food at once
+	int64_t                 m_foodCellIndex; // Cell that is holding the food placed last
+	int                     m_maxFood; // Pieces of food the board is topped up to
+	int                     m_nextMaxFood; // Value of m_maxFood from the next Reset (see SetNumFood)
+	int                     m_numFood;
+	Pcg32                   m_rng;
+	uint64_t                m_seed; // Seed the current game started from
+	int  m_worldWidth;
+	int  m_worldHeight;
+	bool m_noFoodLeft;
+};
+
+template <class Fn>
+void World::ForEachFood(Fn fn) const
+{
+	// With one piece of food there's nothing to search for
+	if (m_maxFood == 1)
+	{
+		if (m_numFood == 1) fn(GetFoodPosition());
+		return;
+	}
+
+	// Otherwise food is picked out of the rows 64 cells at a time
+	for (int y = 0; y < m_worldHeight; y++)
+	{
+		for (int x = 0; x < m_worldWidth; x += BitGrid::BITS_PER_WORD)
+		{
+			for (BitGrid::Word mask = m_foodCells.RowMask(x, y); mask != 0; mask &= mask - 1)
+			{
+				fn(CellPos{ static_cast<CellCoord>(x + Bits::CountTrailingZeros(mask)), static_cast<CellCoord>(y) });
+			}
+		}
+	}
+}
@@ -0,0 +1,307 @@
+#include "WorldBatch.h"
+#include "Snake.h"
+#include "../Engine/BitGrid.h"
+#include "../Engine/Util.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace DirectionTables;
+
+WorldBatch::WorldBatch(int numWorlds, int worldWidth, int worldHeight, const uint64_t* pSeeds)
+	: m_numWorlds(numWorlds)
+	, m_worldWidth(worldWidth)
+	, m_worldHeight(worldHeight)
+	, m_stride(worldWidth + 2)
+	, m_numCells((worldWidth + 2) * (worldHeight + 2))
+	, m_numWords(((worldWidth + 2) * (worldHeight + 2) + BITS_PER_WORD - 1) / BITS_PER_WORD)
+	, m_borderWords(m_numWords)
+	, m_blocks((numWorlds + BLOCK_SIZE - 1) / BLOCK_SIZE)
+	, m_occupied(m_blocks.size() * m_numWords * BLOCK_SIZE)
+	, m_moves(m_blocks.size() * m_numCells * BLOCK_SIZE)
+{
+	assert(numWorlds > 0);
+	assert(worldWidth > 0 && worldHeight > 0 && worldWidth <= World::MAX_SIZE && worldHeight <= World::MAX_SIZE);
+
+	for (int dir = 0; dir < 4; dir++)
+	{
+		m_moveOffsets[dir] = OFFSET_Y[dir] * m_stride + OFFSET_X[dir];
+	}
+
+	for (int y = -1; y <= m_worldHeight; y++)
+	{
+		for (int x = -1; x <= m_worldWidth; x++)
+		{
+			if (!InBounds(x, y))
+			{
+				const int cell = ToCellIndex(x, y);
+				m_borderWords[cell / BITS_PER_WORD] |= Word(1) << (cell % BITS_PER_WORD);
+			}
+		}
+	}
+
+	ResetAll(pSeeds);
+}
+
+WorldBatch::~WorldBatch()
+{
+	Util::DebugPrint("World batch destroyed\n");
+}
+
+void WorldBatch::ResetAll(const uint64_t* pSeeds)
+{
+	assert(pSeeds);
+
+	for (int world = 0; world < m_numWorlds; world++)
+	{
+		Reset(world, pSeeds[world]);
+	}
+}
+
+void WorldBatch::Reset(int world, uint64_t seed)
+{
+	assert(world >= 0 && world < m_numWorlds);
+
+	for (int w = 0; w < m_numWords; w++)
+	{
+		m_occupied[WordIndex(world, w * BITS_PER_WORD)] = m_borderWords[w];
+	}
+
+	const CellPos startPos = Snake::CalcStartPos(m_worldWidth, m_worldHeight);
+	const Direction dir    = Snake::INITIAL_DIRECTION;
+	const int offset       = m_moveOffsets[dir];
+	const int head         = ToCellIndex(startPos.x, startPos.y);
+	const int tail         = head - offset * (static_cast<int>(Snake::INITIAL_LENGTH) - 1);
+
+	Block& block = GetBlock(world);
+	const int j  = world % BLOCK_SIZE;
+
+	block.rng[j].Seed(seed);
+
+	block.head[j]        = head;
+	block.tail[j]        = tail;
+	block.length[j]      = static_cast<uint32_t>(Snake::INITIAL_LENGTH);
+	block.growCounter[j] = 0;
+	block.foodCell[j]    = -1;
+	block.dir[j]         = dir;
+	block.status[j]      = STATUS_ACTIVE;
+	block.noFoodLeft[j]  = false;
+
+	// Lay out the starting body in a line behind the head, as Snake::Init does
+	for (int cell = tail; cell != head + offset; cell += offset)
+	{
+		OccupyCell(world, cell);
+		SetMove(world, cell, dir);
+	}
+
+	GenerateFood(world);
+}
+
+void WorldBatch::Update(int firstWorld, int lastWorld, const Direction* pInputDirs)
+{
+	assert(pInputDirs);
+	assert(firstWorld >= 0 && firstWorld <= lastWorld && lastWorld <= m_numWorlds);
+
+	for (int world = firstWorld; world < lastWorld; world = (world / BLOCK_SIZE + 1) * BLOCK_SIZE)
+	{
+		const int block      = world / BLOCK_SIZE;
+		const int blockStart = block * BLOCK_SIZE;
+		UpdateBlock(block, world - blockStart, std::min(lastWorld - blockStart, BLOCK_SIZE), pInputDirs + blockStart);
+	}
+}
+
+inline void WorldBatch::UpdateMasks(Block& block, int first, int last)
+{
+	// A world whose food has all been eaten is won without moving again
+	for (int j = first; j < last; j++)
+	{
+		const uint8_t active = block.status[j] == STATUS_ACTIVE;
+		const uint8_t won    = active & block.noFoodLeft[j];
+		const uint8_t move   = active ^ won;
+		const uint8_t grow   = move & (block.growCounter[j] > 0);
+		const uint8_t dir    = block.dir[j] ^ ((block.dir[j] ^ (block.inputDir[j] & 3)) & (0 - move));
+
+		block.status[j]      += won * (STATUS_DONE - STATUS_ACTIVE);
+		block.dir[j]          = static_cast<Direction>(dir);
+		block.growCounter[j] -= grow;
+		block.length[j]      += grow; // A head is pushed, and the tail popped unless growing
+		block.moving[j]       = move;
+		block.popTail[j]      = move ^ grow;
+	}
+}
+
+void WorldBatch::UpdateBlock(int block, int first, int last, const Direction* pInputDirs)
+{
+	Block& state      = m_blocks[block];
+	Word* pWords      = &m_occupied[FirstWordIndex(block)];
+	Direction* pMoves = &m_moves[FirstMoveIndex(block)];
+
+	// Kept in a local, as stores to the state could otherwise alias the member
+	int moveOffsets[4];
+	std::copy(m_moveOffsets, m_moveOffsets + 4, moveOffsets);
+
+	// The input is copied into the block, so it can't alias the state. Whole blocks are stepped
+	// with constant bounds, so the loop over the per-world arrays can be vectorised.
+	if (first == 0 && last == BLOCK_SIZE)
+	{
+		std::copy(pInputDirs, pInputDirs + BLOCK_SIZE, state.inputDir);
+		UpdateMasks(state, 0, BLOCK_SIZE);
+	}
+	else
+	{
+		std::copy(pInputDirs + first, pInputDirs + last, state.inputDir + first);
+		UpdateMasks(state, first, last);
+	}
+
+	// Unless the snake is growing, the tail vacates its cell before the head moves
+	for (int j = first; j < last; j++)
+	{
+		const size_t tail = static_cast<uint32_t>(state.tail[j]);
+		const size_t pop  = state.popTail[j];
+		const size_t move = pMoves[tail * BLOCK_SIZE + j];
+
+		pWords[tail / BITS_PER_WORD * BLOCK_SIZE + j] &= ~(Word(pop) << (tail % BITS_PER_WORD));
+		state.tail[j] = static_cast<int32_t>(tail + (moveOffsets[move] & (0 - pop)));
+	}
+
+	// Move the heads, recording each move in the cell of the old head. Snakes that don't move
+	// record theirs in the top left corner of the border instead, which no head can reach. The
+	// head dies if it entered an occupied cell, and the border is occupied, so this also catches
+	// heads that left the world. The cell of a head that died or didn't move is already occupied,
+	// and the food's cell never is, so neither needs a mask.
+	int eaten[BLOCK_SIZE];
+	size_t numEaten = 0;
+	for (int j = first; j < last; j++)
+	{
+		const size_t move = state.moving[j];
+		const size_t head = static_cast<uint32_t>(state.head[j]);
+		const size_t dir  = state.dir[j];
+		const size_t next = static_cast<uint32_t>(head + (moveOffsets[dir] & (0 - move)));
+		const size_t food = static_cast<uint32_t>(state.foodCell[j]);
+
+		pMoves[(head & (0 - move)) * BLOCK_SIZE + j] = static_cast<Direction>(dir);
+
+		Word& word           = pWords[next / BITS_PER_WORD * BLOCK_SIZE + j];
+		const size_t blocked = (word >> (next % BITS_PER_WORD)) & 1;
+
+		word |= Word(1) << (next % BITS_PER_WORD);
+		state.head[j]    = static_cast<int32_t>(next);
+		state.status[j] += static_cast<uint8_t>((move & blocked) * (STATUS_DEAD - STATUS_ACTIVE));
+
+		eaten[numEaten] = j;
+		numEaten += move & (next == food);
+	}
+
+	// Few worlds eat in any one tick, so they are given new food one by one
+	for (size_t k = 0; k < numEaten; k++)
+	{
+		state.growCounter[eaten[k]] += World::FOOD_VALUE;
+		GenerateFood(block * BLOCK_SIZE + eaten[k]);
+	}
+}
+
+CellPos WorldBatch::GetFoodPosition(int world) const
+{
+	const int cell = GetBlock(world).foodCell[world % BLOCK_SIZE];
+	assert(cell >= 0);
+
+	return ToPosition(cell);
+}
+
+CellPos WorldBatch::GetSegment(int world, size_t index) const
+{
+	const size_t length = GetLength(world);
+	assert(index < length);
+
+	// Each segment is a move on from the one behind it
+	int cell = GetBlock(world).tail[world % BLOCK_SIZE];
+	for (size_t i = index + 1; i < length; i++)
+	{
+		cell += m_moveOffsets[GetMove(world, cell)];
+	}
+	return ToPosition(cell);
+}
+
+bool WorldBatch::InBounds(int x, int y) const
+{
+	return (x >= 0 && x < m_worldWidth) &&
+		(y >= 0 && y < m_worldHeight);
+}
+
+bool WorldBatch::IsFree(int world, int x, int y) const
+{
+	assert(InBounds(x, y));
+
+	const int cell = ToCellIndex(x, y);
+	return !IsOccupied(world, cell) && cell != GetBlock(world).foodCell[world % BLOCK_SIZE];
+}
+
+int WorldBatch::CountActive() const
+{
+	int numActive = 0;
+	for (int world = 0; world < m_numWorlds; world++)
+	{
+		numActive += GetStatus(world) == STATUS_ACTIVE;
+	}
+	return numActive;
+}
+
+void WorldBatch::GenerateFood(int world)
+{
+	Block& block = GetBlock(world);
+	const int j  = world % BLOCK_SIZE;
+
+	const int numFree = m_worldWidth * m_worldHeight - static_cast<int>(block.length[j]);
+
+	// No more food can be generated
+	block.noFoodLeft[j] = numFree == 0;
+	if (block.noFoodLeft[j]) return;
+
+	// Select a random free cell and place food there
+	const int cell = FindNthFreeCell(world, block.rng[j].GetInt(0, numFree - 1));
+
+	block.foodCell[j] = cell;
+}
+
+CellPos WorldBatch::ToPosition(int cell) const
+{
+	return CellPos{
+		static_cast<CellCoord>(cell % m_stride - 1),
+		static_cast<CellCoord>(cell / m_stride - 1)
+	};
+}
+
+Direction WorldBatch::GetMove(int world, int cell) const
+{
+	return m_moves[MoveIndex(world, cell)];
+}
+
+void WorldBatch::SetMove(int world, int cell, Direction dir)
+{
+	m_moves[MoveIndex(world, cell)] = dir;
+}
+
+void WorldBatch::OccupyCell(int world, int cell)
+{
+	assert(cell >= 0 && cell < m_numCells);
+
+	m_occupied[WordIndex(world, cell)] |= Word(1) << (cell % BITS_PER_WORD);
+}
+
+bool WorldBatch::IsOccupied(int world, int cell) const
+{
+	assert(cell >= 0 && cell < m_numCells);
+
+	return (m_occupied[WordIndex(world, cell)] >> (cell % BITS_PER_WORD)) & 1;
+}
+
+int WorldBatch::FindNthFreeCell(int world, int n) const
+{
+	assert(n >= 0);
+
+	// The border is always occupied, so the free cells of the bordered board come in the same
+	// order as those of the world
+	const int cell = static_cast<int>(Bits::FindNthClear(&m_occupied[WordIndex(world, 0)], m_numWords, m_numCells, n, BLOCK_SIZE));
+	assert(cell >= 0 && "Not enough free cells!");
+	return cell;
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "World.h"
+#include "WorldTypes.h"
+#include "../Engine/Math/Pcg32.h"
+
+#include <cstdint>
+#include <vector>
+
+// Simulates many independent worlds of the same size in lockstep.
+//
+// Worlds are stored in blocks of BLOCK_SIZE. Within a block the state is a structure of arrays
+// (heads, tails, directions, lengths, grow counters, food cells...) and the per-cell arrays are
+// interleaved by world: word w of the occupancy bits of every world in the block is stored
+// together, as is the move recorded in cell c. Every array of a block is then reached from one
+// pointer at a stride known at compile time, and a range of worlds is a range of memory. One call
+// to Update steps all of them without going through a World, Snake and SnakeBrain per game.
+//
+// Update runs a few kernels over each block in turn: one works out which snakes move and grow,
+// one moves the tails and one moves the heads, checks them for collisions and eats food. They
+// don't branch on the state of a world, so worlds that are finished are stepped with masks rather
+// than skipped, and the kernels over the per-world arrays can be vectorised.
+//
+// Cells are indexed on a board with a border of one cell around it, which is always occupied, so
+// moving out of the world is caught by the same check as moving into the body. A body is kept as
+// its tail and, for each cell of the body, the move onto the next segment towards the head. The
+// food isn't marked as occupied: it's only placed once the last food has become the head, so the
+// occupied cells are always the body and the border.
+//
+// The rules are the same as World::Update and Snake::Simulate: a world in the batch plays
+// out exactly like a World started from the same seed and given the same directions.
+//
+// Worlds that have finished (won or died) are left as they are by Update until they are reset.
+class WorldBatch
+{
+public:
+	// pSeeds holds the seed of each world's first game, one per world
+	WorldBatch(int numWorlds, int worldWidth, int worldHeight, const uint64_t* pSeeds);
+	~WorldBatch();
+
+	// Starts a new game in every world. pSeeds holds one seed per world.
+	void ResetAll(const uint64_t* pSeeds);
+
+	// Starts a new game in a single world
+	void Reset(int world, uint64_t seed);
+
+	// Advances every active world by one tick.
+	// pInputDirs holds the direction each world's snake should move in, one per world.
+	void Update(const Direction* pInputDirs) { Update(0, m_numWorlds, pInputDirs); }
+
+	// Advances the active worlds from firstWorld up to (but not including) lastWorld by one tick.
+	// pInputDirs is indexed by world, as for Update. Ranges that don't overlap can be updated (or
+	// their worlds reset) on different threads at once, e.g. from JobSystem::ParallelFor.
+	void Update(int firstWorld, int lastWorld, const Direction* pInputDirs);
+
+	SnakeStatus GetStatus(int world)  const { return static_cast<SnakeStatus>(GetBlock(world).status[world % BLOCK_SIZE]); }
+	CellPos GetHeadPosition(int world) const { return ToPosition(GetBlock(world).head[world % BLOCK_SIZE]); }
+	Direction GetDirection(int world)  const { return GetBlock(world).dir[world % BLOCK_SIZE]; }
+	size_t GetLength(int world)        const { return GetBlock(world).length[world % BLOCK_SIZE]; }
+	bool IsGrowing(int world)          const { return GetBlock(world).growCounter[world % BLOCK_SIZE] > 0; }
+	CellPos GetFoodPosition(int world) const;
+
+	// Returns the position of a snake's segment, where index 0 is the head. Takes time in
+	// proportion to the length of the snake, as the body is walked from the tail.
+	CellPos GetSegment(int world, size_t index) const;
+
+	// Returns true if the position is within the world limits
+	bool InBounds(int x, int y) const;
+
+	// Returns true if the cell at (x, y) is not occupied by the snake or food
+	bool IsFree(int world, int x, int y) const;
+
+	// Returns the number of worlds that are still being played
+	int CountActive() const;
+
+	int GetNumWorlds() const { return m_numWorlds; }
+	int GetWidth()     const { return m_worldWidth; }
+	int GetHeight()    const { return m_worldHeight; }
+
+private:
+	typedef uint64_t Word;
+	static constexpr int BITS_PER_WORD = 64;
+
+	// Worlds whose state is interleaved. Each kernel steps a whole block before the next one
+	// runs, with the block's per-cell arrays small enough to stay in L1 on the usual boards.
+	static constexpr int BLOCK_SIZE = 64;
+
+	// State of a block of worlds, one element per world
+	struct Block
+	{
+		int32_t   head[BLOCK_SIZE]; // Cell of the head
+		int32_t   tail[BLOCK_SIZE]; // Cell of the tail
+		uint32_t  length[BLOCK_SIZE];
+		int32_t   growCounter[BLOCK_SIZE];
+		int32_t   foodCell[BLOCK_SIZE];
+		Direction dir[BLOCK_SIZE];
+		uint8_t   status[BLOCK_SIZE]; // SnakeStatus
+		uint8_t   noFoodLeft[BLOCK_SIZE];
+		Pcg32     rng[BLOCK_SIZE];
+
+		// Passed between the kernels of an update
+		Direction inputDir[BLOCK_SIZE];
+		uint8_t   moving[BLOCK_SIZE];  // 1 if the snake moves
+		uint8_t   popTail[BLOCK_SIZE]; // 1 if the snake moves without growing
+	};
+
+	// Steps the worlds of a block from first up to (but not including) last, given as indices
+	// within the block. pInputDirs holds the directions of the whole block.
+	void UpdateBlock(int block, int first, int last, const Direction* pInputDirs);
+
+	// Works out which snakes of a block move and grow, and takes their input directions
+	static void UpdateMasks(Block& block, int first, int last);
+
+	void GenerateFood(int world);
+
+	// Move stored for a cell of a world's body, onto the next segment towards the head
+	Direction GetMove(int world, int cell) const;
+	void SetMove(int world, int cell, Direction dir);
+
+	// Occupancy bits of a world
+	void OccupyCell(int world, int cell);
+	bool IsOccupied(int world, int cell) const;
+
+	// Returns the nth (starting from 0, in row-major order) free cell of a world, as World does
+	int FindNthFreeCell(int world, int n) const;
+
+	Block& GetBlock(int world)             { return m_blocks[world / BLOCK_SIZE]; }
+	const Block& GetBlock(int world) const { return m_blocks[world / BLOCK_SIZE]; }
+
+	// Index of the first element of a block's per-cell arrays
+	size_t FirstWordIndex(int block) const { return static_cast<size_t>(block) * m_numWords * BLOCK_SIZE; }
+	size_t FirstMoveIndex(int block) const { return static_cast<size_t>(block) * m_numCells * BLOCK_SIZE; }
+
+	// Index of a world's element of the per-cell arrays holding the given cell
+	size_t WordIndex(int world, int cell) const { return FirstWordIndex(world / BLOCK_SIZE) + static_cast<size_t>(cell / BITS_PER_WORD) * BLOCK_SIZE + world % BLOCK_SIZE; }
+	size_t MoveIndex(int world, int cell) const { return FirstMoveIndex(world / BLOCK_SIZE) + static_cast<size_t>(cell) * BLOCK_SIZE + world % BLOCK_SIZE; }
+
+	// Converts between positions and cell indices on the bordered board
+	int ToCellIndex(int x, int y) const { return (y + 1) * m_stride + x + 1; }
+	CellPos ToPosition(int cell) const;
+
+	const int m_numWorlds;
+	const int m_worldWidth;
+	const int m_worldHeight;
+	const int m_stride;       // Cells in a row of the bordered board
+	const int m_numCells;     // Cells of the bordered board
+	const int m_numWords;     // Occupancy words per world
+	int m_moveOffsets[4];     // Change in cell index of a move in each direction
+
+	// Occupancy of a world at the start of a game, before the snake and food are placed:
+	// only the border is occupied
+	std::vector<Word> m_borderWords;
+
+	// Per world state, in blocks. The last block is padded with worlds that are never played.
+	std::vector<Block> m_blocks;
+
+	// Per cell state of each block in turn, interleaved by world (see WordIndex and MoveIndex)
+	std::vector<Word>      m_occupied; // A set bit marks a cell of the body or the border
+	std::vector<Direction> m_moves;    // Move from each cell of a body onto the next segment towards the head
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "DirectionChain.h"
+#include "World.h"
+#include "WorldTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// A saved game, laid out flat so it can be copied around like plain data.
+//
+// The snapshot is followed directly in memory by the directions from each of the snake's
+// segments to the next, from head to tail, packed four to a byte (see DirectionChain::Pack).
+// Its size depends on the length of the snake rather than the size of the board, at 2 bits a
+// segment. Which cells are occupied isn't stored, as it follows from the body and the food.
+// Snapshots are written by World::Save into storage the caller owns, so cloning a world for
+// lookahead is a memcpy and a World::Restore, with no allocations.
+struct WorldSnapshot
+{
+	WorldState state;
+	CellPos    head;
+	uint32_t   length; // Number of segments in the body
+
+	// Returns the number of bytes a snapshot of a snake with the given length takes, rounded up
+	// so snapshots stored one after another stay aligned
+	static size_t GetSize(size_t length)
+	{
+		const size_t size = sizeof(WorldSnapshot) + DirectionChain::GetPackedSize(length);
+		return (size + alignof(WorldSnapshot) - 1) / alignof(WorldSnapshot) * alignof(WorldSnapshot);
+	}
+	size_t GetSize() const { return GetSize(length); }
+
+	uint8_t* GetLinks()             { return reinterpret_cast<uint8_t*>(this + 1); }
+	const uint8_t* GetLinks() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+};
+
+static_assert(std::is_trivially_copyable<WorldSnapshot>::value, "Snapshots must be copyable with memcpy");
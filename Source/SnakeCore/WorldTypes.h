@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+// Coordinate of a cell along one axis of the world
+typedef int32_t CellCoord;
+
+// Position of a cell in the world
+struct CellPos
+{
+	CellCoord x;
+	CellCoord y;
+};
+
+inline bool operator==(CellPos lhs, CellPos rhs) { return lhs.x == rhs.x && lhs.y == rhs.y; }
+inline bool operator!=(CellPos lhs, CellPos rhs) { return !(lhs == rhs); }
+
+enum SnakeStatus
+{
+	STATUS_ACTIVE, // There is food to be eaten (Still playing)
+	STATUS_DONE, // All food eaten, (Player won!)
+	STATUS_DEAD, 
+};
+
+// The four cardinal directions that the snake can move in.
+// Only the lower two bits are used, so a direction can be packed into two bits.
+enum Direction : uint8_t
+{
+	DIRECTION_NORTH,
+	DIRECTION_EAST,
+	DIRECTION_SOUTH,
+	DIRECTION_WEST,
+};
+
+namespace DirectionTables
+{
+	// Offset of one step in each direction. In SDL +y faces down.
+	constexpr CellCoord OFFSET_X[] = { 0, 1, 0, -1 };
+	constexpr CellCoord OFFSET_Y[] = { -1, 0, 1, 0 };
+
+	// Angle (in degrees) between each direction and the world +x axis
+	constexpr float ANGLE[] = { 90.0f, 0.0f, -90.0f, 180.0f };
+
+	// Angle (in degrees) to rotate the turn sprite by, indexed by [fromParent][fromChild].
+	// The turn sprite can be thought of as a single quadrant of a square (or circle depending on it's smoothness).
+	// By rotating this one graphic through each quadrant of the unit-circle, all four potential orientations can be drawn.
+	// This assumes that the turn texture with no rotation appears to lie in Quadrant I (top-right corner).
+	// Entries where both directions lie along the same axis are not turns and are never used.
+	constexpr float TURN_ANGLE[4][4] =
+	{
+		//  N       E       S       W         <- fromChild
+		{   0.0f,   0.0f,   0.0f,  90.0f }, // N
+		{   0.0f,   0.0f, 270.0f,   0.0f }, // E
+		{   0.0f, 270.0f,   0.0f, 180.0f }, // S
+		{  90.0f,   0.0f, 180.0f,   0.0f }, // W <- fromParent
+	};
+}
+
+// Returns the direction pointing the opposite way
+constexpr Direction Opposite(Direction dir) { return static_cast<Direction>((dir + 2) & 3); }
+
+// Returns true if both directions lie along the same axis
+constexpr bool SameAxis(Direction a, Direction b) { return ((a ^ b) & 1) == 0; }
+
+// Returns the angle (in degrees) between a direction and the world +x axis
+constexpr float ToAngle(Direction dir) { return DirectionTables::ANGLE[dir]; }
+
+// Returns the position of the cell one step away in the given direction
+constexpr CellPos Step(CellPos pos, Direction dir)
+{
+	return CellPos{
+		static_cast<CellCoord>(pos.x + DirectionTables::OFFSET_X[dir]),
+		static_cast<CellCoord>(pos.y + DirectionTables::OFFSET_Y[dir])
+	};
+}
+
+// Returns the direction from a cell to one of its neighbours
+inline Direction DirectionBetween(CellPos from, CellPos to)
+{
+	const int dx = to.x - from.x;
+	const int dy = to.y - from.y;
+	assert((dx == 0) != (dy == 0) && dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1);
+
+	if (dx != 0) return dx > 0 ? DIRECTION_EAST : DIRECTION_WEST;
+	return dy > 0 ? DIRECTION_SOUTH : DIRECTION_NORTH;
+}